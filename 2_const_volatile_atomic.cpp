@@ -4,8 +4,11 @@ In multi-threaded programs, const volatile is useful when one thread updates a v
 Scenario: A Background Sensor Update with a Reader Thread
 A sensor thread continuously updates a read-only shared variable (e.g., temperature).
 A reader thread constantly reads this value to process it.
-The main thread reads it, ensuring the latest data is fetched.*/
+The main thread reads it, ensuring the latest data is fetched.
+Both versions live in this file: the const volatile one builds by default, the std::atomic one with
+-DATOMIC_SENSOR_VERSION (CMake targets const_volatile_example and atomic_sensor_example).*/
 
+#ifndef ATOMIC_SENSOR_VERSION
 #include <iostream>
 #include <thread>
 #include <atomic>
@@ -53,6 +56,7 @@ int main() {
 
     return 0;
 }
+#endif  // !ATOMIC_SENSOR_VERSION
 /*Why const volatile?
 volatile ensures every read fetches the latest data.
 
@@ -116,6 +120,7 @@ Guarantees fresh data while maintaining thread safety.
 
 Code: Thread-Safe Sensor Reader with std::atomic<int> */
 
+#ifdef ATOMIC_SENSOR_VERSION
 #include <iostream>
 #include <thread>
 #include <atomic>
@@ -127,8 +132,8 @@ std::atomic<int> sensorData(25);
 // Background thread simulating sensor updates
 void sensorThread() {
     while (true) {
-        int newValue = sensorData.load() + (rand() % 5 - 2);  // Simulate temperature changes
-        sensorData.store(newValue);  // Atomic update
+        // Simulate temperature changes; fetch_add makes the read-modify-write a single atomic step
+        sensorData.fetch_add(rand() % 5 - 2, std::memory_order_release);
         std::this_thread::sleep_for(std::chrono::milliseconds(500));  // Update every 500ms
     }
 }
@@ -136,7 +141,7 @@ void sensorThread() {
 // Reader thread constantly fetching the latest data
 void readerThread() {
     while (true) {
-        int temp = sensorData.load();  // Atomic read
+        int temp = sensorData.load(std::memory_order_acquire);  // Atomic read, pairs with the release above
         std::cout << "Reader Thread: Latest Sensor Data = " << temp << "°C\n";
         std::this_thread::sleep_for(std::chrono::milliseconds(300));
     }
@@ -158,6 +163,7 @@ int main() {
 
     return 0;
 }
+#endif  // ATOMIC_SENSOR_VERSION
 
 /* Expected Output (Varies Every Run)
 
@@ -175,4 +181,13 @@ Main Thread: Exiting program...
 Why Is This Better?
 1️Safe Multi-Threading: std::atomic<int> ensures that reads and writes are atomic (no race conditions).
 2️ No volatile Needed: std::atomic<int> is specifically designed for multi-threaded synchronization, whereas volatile only prevents compiler optimizations.
-3️ Optimized for Performance: std::atomic is lock-free on most architectures, making it faster than using std::mutex.*/
+3️ Optimized for Performance: std::atomic is lock-free on most architectures, making it faster than using std::mutex.
+
+Limitation: std::atomic<int> only covers a single word. For multi-field samples (value, timestamp,
+sequence number) see SensorChannel<T> in sensor_channel.hpp and the example in sensor_channel.cpp.
+Memory order: load()/store() default to seq_cst. A single publisher only needs release/acquire;
+PublishedValue<T, Order> in atomic_publish.hpp wraps this, and memory_order_benchmark.cpp measures the difference.
+Wakeups: both readers above poll every 300ms. sensor_channel.cpp has a notify mode (C++20 atomic wait/notify
+on the sequence counter) that wakes a reader only when a new sample is published.
+Large shared objects (a whole configuration rather than one reading): publish them through RcuCell<T>
+in epoch_reclaim.hpp, where readers take no reference count and old versions are freed on a background thread.*/
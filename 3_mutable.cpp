@@ -4,27 +4,126 @@ Common for caching mechanisms or debugging flags.
 Example: Logging Access Count in a const Function*/
 
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "cached_value.hpp"
+#include "log_sink.hpp"
+#include "sharded_counter.hpp"
+
+struct LoggerStats {
+    std::uint64_t accessCount;  // showMessage() calls, across all threads
+    std::uint64_t dropped;      // Lines the LogSink had no room for
+};
 
 class Logger {
 private:
-    mutable int accessCount;  // Can be modified inside const functions
+    mutable ShardedCounter<> accessCount;  // Can be modified inside const functions, safe from many threads
+    mutable ShardedCounter<> dropped;
+    LogSink* sink;                         // Optional batched output; nullptr means std::cout
 
 public:
-    Logger() : accessCount(0) {}
+    Logger() : sink(nullptr) {}
+    explicit Logger(LogSink& s) : sink(&s) {}
 
     void showMessage() const {
-        accessCount++;  // Allowed because it's mutable
-        std::cout << "Hello, world! (Accessed " << accessCount << " times)\n";
+        ++accessCount;  // Allowed because it's mutable; a relaxed increment on this thread's shard
+        std::uint64_t count = accessCount.value();  // Sums the shards, so other threads' calls count too
+        if (sink) {
+            if (!sink->log("Hello, world! (Accessed ", count, " times)\n")) {  // Queued, never blocks
+                ++dropped;
+            }
+        } else {
+            std::cout << "Hello, world! (Accessed " << count << " times)\n";
+        }
+    }
+
+    // Aggregates the per-thread shards; call for reporting, not on the hot path
+    LoggerStats stats() const {
+        return LoggerStats{accessCount.value(), dropped.value()};
     }
 };
 
+// Caching example: derived configuration computed lazily in a const getter
+class SensorConfig {
+private:
+    double gain;
+    double offset;
+    CachedValue<std::vector<double>> lookupTable;  // mutable lives inside CachedValue
+    mutable std::atomic<int> rebuilds{0};          // How often the table was actually computed
+
+public:
+    SensorConfig(double g, double o) : gain(g), offset(o) {}
+
+    // Expensive derived value: computed on first use, then served from the cache
+    const std::vector<double>& calibrationTable() const {
+        return lookupTable.get([this] {
+            rebuilds++;
+            std::vector<double> table(4096);
+            for (std::size_t raw = 0; raw < table.size(); ++raw) {
+                table[raw] = gain * static_cast<double>(raw) + offset;
+            }
+            return table;
+        });
+    }
+
+    void setGain(double g) {
+        gain = g;
+        lookupTable.invalidate();  // Mutation: the cached table is stale now
+    }
+
+    int rebuildCount() const { return rebuilds; }
+};
+
 int main() {
     Logger log;
     log.showMessage(); // Access 1
     log.showMessage(); // Access 2
+    std::cout << std::flush;  // Before the LogSink below writes to the same fd
+
+    // The same const logger shared by several worker threads
+    LoggerStats stats;
+    {
+        LogSink console;  // Background flusher batches lines into large write() calls
+        Logger shared(console);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < 4; ++i) {
+            workers.emplace_back([&shared] {
+                for (int n = 0; n < 3; ++n) {
+                    shared.showMessage();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        stats = shared.stats();
+    }
+    std::cout << "Accessed " << stats.accessCount << " times from 4 threads (" << stats.dropped << " dropped)\n";
+
+    SensorConfig config(0.5, -10.0);
+    double sum = 0;
+    for (int i = 0; i < 1000; ++i) {
+        sum += config.calibrationTable()[i];  // Computed once, cached for the other 999 calls
+    }
+    config.setGain(0.25);
+    std::cout << "Calibrated value: " << config.calibrationTable()[100] << " (sum " << sum << ", table built "
+              << config.rebuildCount() << " times)\n";  // 2: once initially, once after setGain()
 }
 
 /*Why mutable?
 
 showMessage() is a const function, meaning it can't modify any member variables—except for mutable ones.
-This is useful for tracking non-critical state changes like debugging counters.*/
+This is useful for tracking non-critical state changes like debugging counters.
+
+Why a ShardedCounter instead of mutable int?
+A const method looks read-only, so callers freely share the object across threads; a mutable int then
+becomes a data race. One std::atomic<int> fixes the race but makes every core fight over one cache line.
+ShardedCounter gives each thread its own padded slot, so the increment never contends. Reading the count
+sums every slot; with threads calling showMessage() at once, two lines can show the same total.
+
+Caching with mutable
+calibrationTable() is logically const: it only returns information the object already implies.
+CachedValue keeps the computed table in mutable storage, so every const call after the first is a
+single atomic load instead of a rebuild, and setGain() throws the stale table away.*/
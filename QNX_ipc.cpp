@@ -7,76 +7,841 @@ The client sends a request using MsgSend(), which blocks until a response is rec
 The server receives the message using MsgReceive(), processes it, and replies using MsgReply().
 The client receives the reply and resumes execution.
 🔹 QNX IPC Example: Client-Server Message Passing
-Let's implement a server that listens for messages and replies, and a client that sends a message to the server.*/
+Let's implement a server that listens for messages and replies, and a client that sends a message to the server.
+The server builds by default, the client with -DQNX_IPC_CLIENT (CMake targets qnx_ipc_server and qnx_ipc_client).*/
 
 //QNX server code
+#ifndef QNX_IPC_CLIENT
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/neutrino.h>
 #include <sys/netmgr.h>
+#include <sys/dispatch.h>
+#include <sys/iomsg.h>
 #include <string.h>
 
-#define SERVER_CHANNEL 1  // Arbitrary channel ID
+#include "qnx_ipc.h"
 
+#define MAX_SHM_REGIONS 16
+#define MAX_MSG_TYPE 0xFF  // User types stay below _IO_BASE
+#define MAX_WORKERS 64
+
+// A client's region, mapped read-only into the server.
+// Workers read frames outside shm_regions_lock, so a region is unmapped only once no frame is using it:
+// detaching marks it, and the last reader (or the detach itself, if nobody is reading) unmaps it.
 typedef struct {
+    const unsigned char* base;
+    size_t size;
+    pid_t owner;      // Only the process that attached a region may use or detach it
+    int owner_scoid;  // Server connection it arrived on, released when that client disconnects
+    int users;        // Frames being read right now (taken by lookup_region, dropped by unuse_region)
+    int detached;     // No new lookups; unmapped when users drops to 0
+} ShmRegion;
+
+static ShmRegion shm_regions[MAX_SHM_REGIONS];
+static pthread_mutex_t shm_regions_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// With shm_regions_lock held: stops new lookups of region id. Returns 1 and the mapping in *unmap
+// if nobody is reading it (the caller unmaps it after unlocking); otherwise the last reader does.
+static int retire_region_locked(int id, ShmRegion* unmap) {
+    shm_regions[id].detached = 1;
+    if (shm_regions[id].users > 0) {
+        return 0;
+    }
+    *unmap = shm_regions[id];
+    memset(&shm_regions[id], 0, sizeof(shm_regions[id]));
+    return 1;
+}
+
+// Running totals of telemetry pulses
+static uint64_t telemetry_count;
+static int64_t telemetry_sum;
+static pthread_mutex_t telemetry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Receive buffer large enough for any request
+typedef union {
     int msg_type;
-    char text[100];
-} Message;
+    struct _pulse pulse;  // When MsgReceive() returns rcvid == 0
+    struct {
+        uint16_t type;    // QNX system messages (_IO_CONNECT from name_open() etc.)
+        uint16_t subtype;
+    } io;
+    Message text;
+    AsyncJobMsg async_job;
+    ShmAttachMsg shm_attach;
+    ShmFrameMsg shm_frame;
+    ShmDetachMsg shm_detach;
+    struct {
+        MsgHeader header;
+        unsigned char payload[SERVER_INLINE_PAYLOAD];  // Larger payloads are pulled with MsgRead()
+    } record;
+} ServerMsg;
 
-int main() {
-    int chid = ChannelCreate(0);
-    if (chid == -1) {
-        perror("ChannelCreate failed");
-        return -1;
+// Handlers are registered per msg_type instead of being hard-coded in the receive loop
+typedef void (*MsgHandler)(int rcvid, ServerMsg* msg, const struct _msg_info* info);
+
+typedef struct {
+    MsgHandler handler;
+    size_t min_len;  // Shorter messages are rejected with EBADMSG before the handler runs
+} DispatchEntry;
+
+static DispatchEntry dispatch_table[MAX_MSG_TYPE + 1];
+static int verbose = 1;  // -q turns off per-message printing (for benchmarks)
+
+static uint64_t expired_requests;  // Rejected because their deadline had passed on arrival
+static pthread_mutex_t expired_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void register_handler(int msg_type, size_t min_len, MsgHandler handler) {
+    dispatch_table[msg_type].handler = handler;
+    dispatch_table[msg_type].min_len = min_len;
+}
+
+static void dispatch(int rcvid, ServerMsg* msg, const struct _msg_info* info) {
+    if (msg->msg_type <= 0 || msg->msg_type > MAX_MSG_TYPE || dispatch_table[msg->msg_type].handler == NULL) {
+        MsgError(rcvid, ENOSYS);
+        return;
+    }
+    const DispatchEntry* entry = &dispatch_table[msg->msg_type];
+    if (info->msglen < entry->min_len) {
+        MsgError(rcvid, EBADMSG);
+        return;
+    }
+    entry->handler(rcvid, msg, info);
+}
+
+static void handle_text(int rcvid, ServerMsg* request, const struct _msg_info* info) {
+    (void)info;
+    const Message* msg = &request->text;
+    if (verbose) {
+        printf("Received message: %s\n", msg->text);
+    }
+
+    // Replying to the client
+    Message reply;
+    reply.msg_type = MSG_TEXT;
+    strcpy(reply.text, "Hello from the server!");
+    MsgReply(rcvid, 0, &reply, sizeof(reply));
+}
+
+// Returns the payload of a MsgHeader message, fetching it with MsgRead() when it did not fit in the
+// receive buffer (*large is then set and must be freed). On error replies with MsgError() and returns NULL.
+static unsigned char* receive_payload(int rcvid, ServerMsg* msg, const struct _msg_info* info, unsigned char** large) {
+    uint32_t len = msg->record.header.payload_len;
+    *large = NULL;
+    if (info->srcmsglen != sizeof(MsgHeader) + len) {
+        MsgError(rcvid, EBADMSG);
+        return NULL;
     }
 
-    printf("Server running. Waiting for messages...\n");
+    // Too late to be useful: fail fast instead of delaying requests that can still make it
+    uint64_t deadline = msg->record.header.deadline_ns;
+    if (deadline != 0) {
+        uint64_t now = ipc_now_ns();
+        if (now > deadline) {
+            MsgError(rcvid, ETIMEDOUT);
+            pthread_mutex_lock(&expired_lock);
+            uint64_t expired = ++expired_requests;
+            pthread_mutex_unlock(&expired_lock);
+            if (verbose) {
+                printf("Rejected request from pid %d (prio %d): %llu us past deadline, %llu expired so far\n",
+                       info->pid, info->priority, (unsigned long long)((now - deadline) / 1000),
+                       (unsigned long long)expired);
+            }
+            return NULL;
+        }
+    }
+
+    if (len <= SERVER_INLINE_PAYLOAD) {
+        return msg->record.payload;
+    }
+
+    // Too big for the receive buffer: pull the whole payload straight from the client into one buffer
+    *large = (unsigned char*)malloc(len);
+    if (*large == NULL) {
+        MsgError(rcvid, ENOMEM);
+        return NULL;
+    }
+    if (MsgRead(rcvid, *large, len, sizeof(MsgHeader)) != (ssize_t)len) {
+        free(*large);
+        *large = NULL;
+        MsgError(rcvid, EFAULT);
+        return NULL;
+    }
+    return *large;
+}
+
+static void log_record(const unsigned char* payload, uint32_t len) {
+    if (!verbose) {
+        // Benchmark mode: no output
+    } else if (len <= 80) {
+        printf("Received record: %.*s\n", (int)len, (const char*)payload);
+    } else {
+        printf("Received %u-byte record (checksum %08x)\n", len, payload_checksum(payload, len));
+    }
+}
+
+static void handle_record(int rcvid, ServerMsg* msg, const struct _msg_info* info) {
+    unsigned char* large;
+    unsigned char* payload = receive_payload(rcvid, msg, info, &large);
+    if (payload == NULL) {
+        return;
+    }
+    log_record(payload, msg->record.header.payload_len);
+    free(large);
+
+    // Reply with exactly the bytes used: header + text, no fixed-size struct
+    static const char text[] = "Hello from the server!";
+    MsgHeader header = { MSG_RECORD, sizeof(text) - 1, 0 };
+    iov_t riov[2];
+    SETIOV(&riov[0], &header, sizeof(header));
+    SETIOV(&riov[1], text, sizeof(text) - 1);
+    MsgReplyv(rcvid, 0, riov, 2);
+}
+
+// A client went away: unmap whatever it left attached and free its server connection
+static void release_client(int scoid) {
+    for (int id = 0; id < MAX_SHM_REGIONS; id++) {
+        ShmRegion region;
+        int unmap = 0;
+        pthread_mutex_lock(&shm_regions_lock);
+        if (shm_regions[id].base != NULL && !shm_regions[id].detached && shm_regions[id].owner_scoid == scoid) {
+            unmap = retire_region_locked(id, &region);
+        }
+        pthread_mutex_unlock(&shm_regions_lock);
+        if (unmap) {
+            munmap((void*)region.base, region.size);
+        }
+    }
+    ConnectDetach(scoid);
+}
+
+// Pulses carry no rcvid and get no reply
+static void handle_pulse(const struct _pulse* pulse) {
+    switch (pulse->code) {
+    case _PULSE_CODE_DISCONNECT:
+        release_client(pulse->scoid);
+        break;
+    case PULSE_CODE_TELEMETRY: {
+        pthread_mutex_lock(&telemetry_lock);
+        uint64_t count = ++telemetry_count;
+        telemetry_sum += pulse->value.sival_int;
+        int64_t sum = telemetry_sum;
+        pthread_mutex_unlock(&telemetry_lock);
+        if (verbose && count % 1000 == 0) {
+            printf("Telemetry: %llu pulses, mean value %.2f\n", (unsigned long long)count, (double)sum / count);
+        }
+        break;
+    }
+    default:
+        break;  // Kernel pulses (e.g. _PULSE_CODE_UNBLOCK) need no action here
+    }
+}
 
+typedef struct {
+    int rcvid;
+    AsyncJobMsg msg;
+} AsyncJob;
+
+static void* run_async_job(void* arg) {
+    AsyncJob* job = (AsyncJob*)arg;
+    usleep(job->msg.work_us);  // Simulated processing
+    if (MsgDeliverEvent(job->rcvid, &job->msg.event) == -1) {
+        perror("MsgDeliverEvent failed");  // Client has gone away
+    }
+    free(job);
+    return NULL;
+}
+
+// Accept the job, unblock the client immediately, report completion later
+static void handle_async_job(int rcvid, ServerMsg* request, const struct _msg_info* info) {
+    (void)info;
+    AsyncJob* job = (AsyncJob*)malloc(sizeof(AsyncJob));
+    if (job == NULL) {
+        MsgError(rcvid, ENOMEM);
+        return;
+    }
+    job->rcvid = rcvid;
+    job->msg = request->async_job;
+
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, run_async_job, job) != 0) {
+        free(job);
+        MsgError(rcvid, EAGAIN);
+        return;
+    }
+    pthread_detach(tid);
+    MsgReply(rcvid, 0, NULL, 0);
+}
+
+// Many small records in one message: one (possibly cross-node) round trip instead of one per record
+static void handle_batch(int rcvid, ServerMsg* msg, const struct _msg_info* info) {
+    unsigned char* large;
+    unsigned char* payload = receive_payload(rcvid, msg, info, &large);
+    if (payload == NULL) {
+        return;
+    }
+
+    BatchReply reply = { 0, 0 };
+    uint32_t len = msg->record.header.payload_len;
+    uint32_t pos = 0;
+    while (pos + sizeof(BatchEntry) <= len) {
+        BatchEntry entry;
+        memcpy(&entry, payload + pos, sizeof(entry));
+        uint32_t data = pos + sizeof(BatchEntry);
+        if (entry.len > len - data) {
+            reply.rejected++;  // Truncated entry: stop here
+            break;
+        }
+        if (entry.msg_type == MSG_RECORD) {
+            log_record(payload + data, entry.len);
+            reply.processed++;
+        } else {
+            reply.rejected++;
+        }
+        pos = IPC_BATCH_ALIGN(data + entry.len);
+    }
+    free(large);
+    MsgReply(rcvid, 0, &reply, sizeof(reply));
+}
+
+static void handle_shm_attach(int rcvid, ServerMsg* request, const struct _msg_info* info) {
+    const ShmAttachMsg* msg = &request->shm_attach;
+    if (msg->name[0] != '/' || memchr(msg->name, '\0', SHM_NAME_MAX) == NULL || msg->size < SHM_PAYLOAD_OFFSET) {
+        MsgError(rcvid, EINVAL);
+        return;
+    }
+
+    int fd = shm_open(msg->name, O_RDONLY, 0);
+    if (fd == -1) {
+        MsgError(rcvid, errno);
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (uint64_t)st.st_size < msg->size) {  // Mapping past the object would fault on access
+        close(fd);
+        MsgError(rcvid, EINVAL);
+        return;
+    }
+    void* base = mmap(NULL, msg->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // The mapping keeps the region alive
+    if (base == MAP_FAILED) {
+        MsgError(rcvid, errno);
+        return;
+    }
+    const ShmRegionHeader* header = (const ShmRegionHeader*)base;
+    if (header->magic != SHM_REGION_MAGIC || header->size != msg->size) {
+        munmap(base, msg->size);
+        MsgError(rcvid, EINVAL);
+        return;
+    }
+
+    pthread_mutex_lock(&shm_regions_lock);
+    int id = 0;
+    while (id < MAX_SHM_REGIONS && shm_regions[id].base != NULL) {  // Detached regions still being read stay taken
+        id++;
+    }
+    if (id < MAX_SHM_REGIONS) {
+        shm_regions[id].base = (const unsigned char*)base;
+        shm_regions[id].size = msg->size;
+        shm_regions[id].owner = info->pid;
+        shm_regions[id].owner_scoid = info->scoid;
+        shm_regions[id].users = 0;
+        shm_regions[id].detached = 0;
+    }
+    pthread_mutex_unlock(&shm_regions_lock);
+    if (id == MAX_SHM_REGIONS) {
+        munmap(base, msg->size);
+        MsgError(rcvid, ENOSPC);
+        return;
+    }
+    if (verbose) printf("Mapped shared memory %s (%llu bytes) as region %d\n", msg->name, (unsigned long long)msg->size, id);
+
+    ShmAttachReply reply;
+    reply.region_id = id;
+    MsgReply(rcvid, 0, &reply, sizeof(reply));
+}
+
+// Copies out the region if it exists and belongs to pid, and keeps it mapped until unuse_region(id)
+static int lookup_region(int id, pid_t pid, ShmRegion* out) {
+    int found = 0;
+    if (id >= 0 && id < MAX_SHM_REGIONS) {
+        pthread_mutex_lock(&shm_regions_lock);
+        if (shm_regions[id].base != NULL && !shm_regions[id].detached && shm_regions[id].owner == pid) {
+            shm_regions[id].users++;
+            *out = shm_regions[id];
+            found = 1;
+        }
+        pthread_mutex_unlock(&shm_regions_lock);
+    }
+    return found;
+}
+
+// Ends a lookup_region(); the last reader of a detached region unmaps it
+static void unuse_region(int id) {
+    ShmRegion region;
+    int unmap = 0;
+    pthread_mutex_lock(&shm_regions_lock);
+    if (--shm_regions[id].users == 0 && shm_regions[id].detached) {
+        unmap = retire_region_locked(id, &region);
+    }
+    pthread_mutex_unlock(&shm_regions_lock);
+    if (unmap) {
+        munmap((void*)region.base, region.size);
+    }
+}
+
+static void handle_shm_frame(int rcvid, ServerMsg* request, const struct _msg_info* info) {
+    const ShmFrameMsg* msg = &request->shm_frame;
+    ShmRegion found;
+    if (!lookup_region(msg->region_id, info->pid, &found)) {
+        MsgError(rcvid, EBADF);
+        return;
+    }
+    const ShmRegion* region = &found;
+    if (msg->offset < SHM_PAYLOAD_OFFSET || msg->offset > region->size || msg->length > region->size - msg->offset) {
+        unuse_region(msg->region_id);
+        MsgError(rcvid, EINVAL);
+        return;
+    }
+    const ShmRegionHeader* header = (const ShmRegionHeader*)region->base;
+    uint32_t before = __atomic_load_n(&header->generation, __ATOMIC_ACQUIRE);
+    if (before != msg->generation || (before & 1)) {
+        unuse_region(msg->region_id);
+        MsgError(rcvid, ESTALE);  // Client already reused (or is rewriting) the buffer
+        return;
+    }
+
+    // Zero-copy: the payload is read in place from the client's pages
+    uint32_t checksum = payload_checksum(region->base + msg->offset, msg->length);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);  // The payload reads above complete before the second load
+    uint32_t after = __atomic_load_n(&header->generation, __ATOMIC_RELAXED);
+    unuse_region(msg->region_id);  // Done with the mapping
+    if (after != before) {
+        MsgError(rcvid, ESTALE);  // Overwritten while we were reading it
+        return;
+    }
+
+    ShmFrameReply reply;
+    reply.generation = msg->generation;
+    reply.checksum = checksum;
+    MsgReply(rcvid, 0, &reply, sizeof(reply));
+}
+
+static void handle_shm_detach(int rcvid, ServerMsg* request, const struct _msg_info* info) {
+    const ShmDetachMsg* msg = &request->shm_detach;
+    int id = msg->region_id;
+    ShmRegion region;
+    int found = 0;
+    int unmap = 0;
+    pthread_mutex_lock(&shm_regions_lock);
+    if (id >= 0 && id < MAX_SHM_REGIONS && shm_regions[id].base != NULL && !shm_regions[id].detached &&
+        shm_regions[id].owner == info->pid) {
+        found = 1;
+        unmap = retire_region_locked(id, &region);  // Frames still being read keep it mapped until they finish
+    }
+    pthread_mutex_unlock(&shm_regions_lock);
+    if (!found) {
+        MsgError(rcvid, EBADF);
+        return;
+    }
+    if (unmap) {
+        munmap((void*)region.base, region.size);
+    }
+    MsgReply(rcvid, 0, NULL, 0);
+}
+
+// Every worker blocks in MsgReceive() on the same channel; the kernel hands each message to one of them
+static void* receive_loop(void* arg) {
+    int chid = *(const int*)arg;
     while (1) {
-        Message msg;
-        int rcvid = MsgReceive(chid, &msg, sizeof(msg), NULL);
+        ServerMsg msg;
+        struct _msg_info info;
+        int rcvid = MsgReceive(chid, &msg, sizeof(msg), &info);
         if (rcvid == -1) {
             perror("MsgReceive failed");
             continue;
         }
+        if (rcvid == 0) {
+            handle_pulse(&msg.pulse);
+            continue;
+        }
+        if (msg.io.type == _IO_CONNECT) {
+            MsgReply(rcvid, EOK, NULL, 0);  // Sent by name_open()
+            continue;
+        }
+        if (msg.io.type > _IO_BASE && msg.io.type <= _IO_MAX) {
+            MsgError(rcvid, ENOSYS);  // Other system messages are not supported
+            continue;
+        }
+        dispatch(rcvid, &msg, &info);
+    }
+    return NULL;
+}
 
-        printf("Received message: %s\n", msg.text);
+int main(int argc, char* argv[]) {
+    int num_workers = 1;                 // -t <n>: receive threads on the channel
+    const char* name = IPC_SERVER_NAME;  // -n <name>: lets several servers run side by side
+    int fixed_priority = 0;              // -F: _NTO_CHF_FIXED_PRIORITY, no priority inheritance
+    int worker_priority = 0;             // -P <prio>: SCHED_FIFO priority of the receive threads
+    int opt;
+    while ((opt = getopt(argc, argv, "t:qn:FP:")) != -1) {
+        switch (opt) {
+        case 'F':
+            fixed_priority = 1;
+            break;
+        case 'P':
+            worker_priority = atoi(optarg);
+            break;
+        case 'n':
+            name = optarg;
+            break;
+        case 't':
+            num_workers = atoi(optarg);
+            break;
+        case 'q':
+            verbose = 0;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n name] [-t threads] [-q] [-F] [-P priority]\n", argv[0]);
+            return -1;
+        }
+    }
+    if (num_workers < 1 || num_workers > MAX_WORKERS) {
+        fprintf(stderr, "Thread count must be 1..%d\n", MAX_WORKERS);
+        return -1;
+    }
+
+    register_handler(MSG_TEXT, sizeof(Message), handle_text);
+    register_handler(MSG_SHM_ATTACH, sizeof(ShmAttachMsg), handle_shm_attach);
+    register_handler(MSG_SHM_FRAME, sizeof(ShmFrameMsg), handle_shm_frame);
+    register_handler(MSG_SHM_DETACH, sizeof(ShmDetachMsg), handle_shm_detach);
+    register_handler(MSG_RECORD, sizeof(MsgHeader), handle_record);
+    register_handler(MSG_ASYNC_JOB, sizeof(AsyncJobMsg), handle_async_job);
+    register_handler(MSG_BATCH, sizeof(MsgHeader), handle_batch);
+
+    // name_attach() creates the channel (with disconnect/unblock pulses enabled) and registers the name.
+    // For a fixed-priority channel we create it ourselves and hand it to name_attach() through a dispatch handle.
+    name_attach_t* attach;
+    if (fixed_priority) {
+        int rt_chid = ChannelCreate(_NTO_CHF_FIXED_PRIORITY | _NTO_CHF_DISCONNECT | _NTO_CHF_UNBLOCK);
+        dispatch_t* dpp = rt_chid == -1 ? NULL : dispatch_create_channel(rt_chid, DISPATCH_FLAG_NOLOCK);
+        if (dpp == NULL) {
+            perror("Creating fixed-priority channel failed");
+            return -1;
+        }
+        attach = name_attach(dpp, name, 0);
+    } else {
+        attach = name_attach(NULL, name, 0);
+    }
+    if (attach == NULL) {
+        perror("name_attach failed");
+        return -1;
+    }
+    int chid = attach->chid;
+
+    // With inheritance (the default) a receive thread runs at the sending client's priority;
+    // with -F it stays at this priority, so set one that outranks the clients it must not be delayed by
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (worker_priority > 0) {
+        struct sched_param param;
+        param.sched_priority = worker_priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            fprintf(stderr, "pthread_setschedparam failed: %s\n", strerror(err));
+            return -1;
+        }
+    }
+
+    printf("Server '%s' (pid %d, chid %d) running with %d receive thread(s)%s. Waiting for messages...\n",
+           name, getpid(), chid, num_workers, fixed_priority ? ", fixed priority" : ", priority inheritance");
 
-        // Replying to the client
-        Message reply;
-        reply.msg_type = 1;
-        strcpy(reply.text, "Hello from the server!");
-        MsgReply(rcvid, 0, &reply, sizeof(reply));
+    // The main thread is worker 0; start the rest
+    for (int i = 1; i < num_workers; i++) {
+        pthread_t tid;
+        int err = pthread_create(&tid, &attr, receive_loop, &chid);
+        if (err != 0) {
+            fprintf(stderr, "pthread_create failed: %s\n", strerror(err));
+            return -1;
+        }
+        pthread_detach(tid);
     }
+    receive_loop(&chid);
 
     return 0;
 }
+#endif  // !QNX_IPC_CLIENT
 
 //qnx client code
+#ifdef QNX_IPC_CLIENT
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/neutrino.h>
 #include <sys/netmgr.h>
 #include <string.h>
 
-#define SERVER_CHANNEL 1  // Same ID as server
+#include "qnx_ipc.h"
 
-typedef struct {
-    int msg_type;
-    char text[100];
-} Message;
+// Sends one frame of frame_bytes through shared memory instead of through the channel
+static int send_shm_frame(int server_coid, size_t frame_bytes) {
+    ShmClientRegion region;
+    if (ipc_shm_attach(server_coid, frame_bytes, 0, &region) == -1) {
+        return -1;
+    }
 
-int main() {
-    int server_coid = ConnectAttach(ND_LOCAL_NODE, 0, SERVER_CHANNEL, _NTO_SIDE_CHANNEL, 0);
-    if (server_coid == -1) {
+    // The "camera" writes the frame directly into shared memory
+    ipc_shm_begin_frame(&region);
+    for (size_t i = 0; i < frame_bytes; i++) {
+        region.payload[i] = (unsigned char)(i * 7);
+    }
+
+    int result = -1;
+    ShmFrameReply reply;
+    if (ipc_shm_send_frame(server_coid, &region, frame_bytes, &reply) == -1) {
+        perror("MsgSend(MSG_SHM_FRAME) failed");
+    } else {
+        uint32_t expected = payload_checksum(region.payload, frame_bytes);
+        printf("Server processed %zu-byte frame #%u in place (checksum %s)\n",
+               frame_bytes, reply.generation, reply.checksum == expected ? "OK" : "MISMATCH");
+        result = 0;
+    }
+
+    ipc_shm_detach(server_coid, &region);
+    return result;
+}
+
+// Sends a variable-length record: header + payload, no padding and no copy into a struct.
+// Goes through the cached connection, so a restarted server is reconnected transparently.
+// deadline_us > 0 asks the server to drop the request if it arrives later than that.
+static int send_record(IpcConnection* server, const void* payload, uint32_t len, long deadline_us) {
+    char reply[128];
+    long reply_len;
+    int coid;
+    uint64_t deadline = deadline_us > 0 ? ipc_now_ns() + (uint64_t)deadline_us * 1000 : 0;
+    do {
+        coid = ipc_connection_coid(server);
+        reply_len = coid == -1 ? -1
+                               : ipc_send_record_deadline(coid, MSG_RECORD, payload, len, deadline, reply, sizeof(reply));
+    } while (reply_len == -1 && ipc_connection_recover(server, errno, coid));
+    if (reply_len == -1 && errno == ETIMEDOUT) {
+        printf("Request rejected: deadline of %ld us expired before the server got to it\n", deadline_us);
+        return -1;
+    }
+    if (reply_len == -1) {
+        perror("MsgSendv failed");
+        return -1;
+    }
+    if (reply_len > (long)sizeof(reply)) {
+        reply_len = sizeof(reply);
+    }
+    printf("Received reply: %.*s\n", (int)reply_len, reply);
+    return 0;
+}
+
+// A large record: the server fetches everything past its inline buffer with MsgRead()
+static int send_large_record(IpcConnection* server, size_t record_bytes, long deadline_us) {
+    unsigned char* record = (unsigned char*)malloc(record_bytes);
+    if (record == NULL) {
+        perror("malloc failed");
+        return -1;
+    }
+    for (size_t i = 0; i < record_bytes; i++) {
+        record[i] = (unsigned char)(i * 7);
+    }
+    printf("Sending %zu-byte record (checksum %08x)\n", record_bytes, payload_checksum(record, record_bytes));
+    int result = send_record(server, record, (uint32_t)record_bytes, deadline_us);
+    free(record);
+    return result;
+}
+
+// Fire-and-forget telemetry: each pulse is queued by the kernel, the client never blocks on a reply
+static int send_telemetry(int server_coid, int count) {
+    int value = 25;
+    for (int i = 0; i < count; i++) {
+        value += rand() % 5 - 2;
+        if (MsgSendPulse(server_coid, -1, PULSE_CODE_TELEMETRY, value) == -1) {  // -1: sender's priority
+            perror("MsgSendPulse failed");
+            return -1;
+        }
+    }
+    printf("Sent %d telemetry pulses\n", count);
+    return 0;
+}
+
+// Hand a job to the server and get notified on our own channel when it finishes
+static int run_async_job(int server_coid) {
+    int chid = ChannelCreate(_NTO_CHF_PRIVATE);
+    if (chid == -1) {
+        perror("ChannelCreate failed");
+        return -1;
+    }
+    int self_coid = ConnectAttach(ND_LOCAL_NODE, 0, chid, _NTO_SIDE_CHANNEL, 0);
+    if (self_coid == -1) {
         perror("ConnectAttach failed");
         return -1;
     }
 
+    AsyncJobMsg job;
+    job.msg_type = MSG_ASYNC_JOB;
+    job.job_id = 42;
+    job.work_us = 200000;
+    SIGEV_PULSE_INIT(&job.event, self_coid, SIGEV_PULSE_PRIO_INHERIT, PULSE_CODE_JOB_DONE, job.job_id);
+#if _NTO_VERSION >= 710
+    // QNX 7.1+ only delivers events the client registered for this server connection
+    if (MsgRegisterEvent(&job.event, server_coid) == -1) {
+        perror("MsgRegisterEvent failed");
+        return -1;
+    }
+#endif
+
+    if (MsgSend(server_coid, &job, sizeof(job), NULL, 0) == -1) {  // Returns as soon as the job is accepted
+        perror("MsgSend(MSG_ASYNC_JOB) failed");
+        return -1;
+    }
+    printf("Job %u accepted, client continues with other work...\n", job.job_id);
+
+    struct _pulse pulse;
+    if (MsgReceivePulse(chid, &pulse, sizeof(pulse), NULL) == -1) {
+        perror("MsgReceivePulse failed");
+        return -1;
+    }
+    printf("Job %d completed (pulse code %d)\n", pulse.value.sival_int, pulse.code);
+
+    ConnectDetach(self_coid);
+    ChannelDestroy(chid);
+    return 0;
+}
+
+// Sends count short records in as few messages as possible
+static int send_batched(IpcConnection* server, int count) {
+    static IpcBatch batch;  // 8KB buffer, keep it off the stack
+    ipc_batch_init(&batch, server);
+    for (int i = 0; i < count; i++) {
+        char text[32];
+        int len = snprintf(text, sizeof(text), "Sample %d", i);
+        if (ipc_batch_add(&batch, text, (uint16_t)len) == -1) {
+            perror("ipc_batch_add failed");
+            return -1;
+        }
+    }
+    if (ipc_batch_flush(&batch) == -1) {
+        perror("ipc_batch_flush failed");
+        return -1;
+    }
+    printf("Server processed %llu of %d records in %llu round trip(s)\n",
+           (unsigned long long)batch.total_processed, count, (unsigned long long)batch.round_trips);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t shm_frame_bytes = 0;  // -s <bytes>: send a frame through shared memory
+    size_t record_bytes = 0;     // -r <bytes>: send one large header + payload record
+    int fixed_message = 0;       // -f: original fixed-size Message for comparison
+    int telemetry_pulses = 0;    // -p <count>: send one-way telemetry pulses
+    int async_job = 0;           // -j: submit a job and wait for its completion event
+    const char* name = IPC_SERVER_NAME;  // -n <name>: which server instance to talk to
+    const char* node = NULL;             // -N <node> -i <pid> -c <chid>: server on another Qnet node
+    pid_t remote_pid = 0;
+    int remote_chid = -1;
+    int batch_records = 0;               // -b <count>: send count records batched into few messages
+    long deadline_us = 0;                // -d <us>: records must reach the server within this time
+    int opt;
+    while ((opt = getopt(argc, argv, "s:r:fp:jn:N:i:c:b:d:")) != -1) {
+        switch (opt) {
+        case 'd':
+            deadline_us = atol(optarg);
+            break;
+        case 'N':
+            node = optarg;
+            break;
+        case 'i':
+            remote_pid = (pid_t)atoi(optarg);
+            break;
+        case 'c':
+            remote_chid = atoi(optarg);
+            break;
+        case 'b':
+            batch_records = atoi(optarg);
+            break;
+        case 'n':
+            name = optarg;
+            break;
+        case 'p':
+            telemetry_pulses = atoi(optarg);
+            break;
+        case 'j':
+            async_job = 1;
+            break;
+        case 's':
+            shm_frame_bytes = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            record_bytes = strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            fixed_message = 1;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n name | -N node -i pid -c chid] "
+                            "[-s frame_bytes | -r record_bytes | -f | -p pulses | -j | -b records] [-d deadline_us]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    // Resolved once (name_open() locally, netmgr_strtond() + ConnectAttach() over Qnet); later calls reuse the coid
+    static IpcConnection remote;
+    IpcConnection* server;
+    if (node != NULL) {
+        ipc_connection_init_remote(&remote, node, remote_pid, remote_chid);
+        server = &remote;
+    } else {
+        server = ipc_connection_cached(name);
+    }
+    int server_coid = ipc_connection_coid(server);
+    if (server_coid == -1) {
+        perror(node != NULL ? "Connecting to remote node failed" : "name_open failed");
+        return -1;
+    }
+
+    if (shm_frame_bytes > 0) {
+        return send_shm_frame(server_coid, shm_frame_bytes);
+    }
+    if (record_bytes > 0) {
+        return send_large_record(server, record_bytes, deadline_us);
+    }
+    if (telemetry_pulses > 0) {
+        return send_telemetry(server_coid, telemetry_pulses);
+    }
+    if (batch_records > 0) {
+        return send_batched(server, batch_records);
+    }
+    if (async_job) {
+        return run_async_job(server_coid);
+    }
+    if (!fixed_message) {
+        static const char hello[] = "Hello, Server!";
+        return send_record(server, hello, sizeof(hello) - 1, deadline_us);  // 16 + 14 bytes instead of 104
+    }
+
     Message msg;
-    msg.msg_type = 1;
+    msg.msg_type = MSG_TEXT;
     strcpy(msg.text, "Hello, Server!");
 
     Message reply;
@@ -89,17 +854,18 @@ int main() {
     printf("Received reply: %s\n", reply.text);
     return 0;
 }
+#endif  // QNX_IPC_CLIENT
 
 /*Explanation of the Code
 The Server:
 
-Creates a message channel (ChannelCreate()).
+Registers its name and creates a message channel (name_attach(), which wraps ChannelCreate()).
 Waits for messages using MsgReceive().
 Processes the received message.
 Sends a reply back using MsgReply().
 The Client:
 
-Connects to the server using ConnectAttach().
+Looks the server up by name (name_open(), which wraps ConnectAttach()) and caches the connection.
 Sends a message to the server using MsgSend(), which blocks until a response is received.
 Receives the server's response and prints it.
 🔹 Expected Output
@@ -127,4 +893,52 @@ Shared Memory (shm_open()) – Best for high-speed large data transfer.
 Signals (kill(), sigaction()) – Used for process notifications.
 Pipes & FIFOs (pipe(), mkfifo()) – Simple inter-process streaming.
 Sockets (socket()) – For network communication between different machines.
-Would you like an example of another IPC method like shared memory or signals?*/
+Would you like an example of another IPC method like shared memory or signals?
+
+🔹 Beyond the Basic Example
+The server and client options below build on message passing and shared memory:
+
+ Shared-Memory Frames (client -s <bytes>)
+With -s the frame is written into a shm_open()/mmap() region instead of being copied through the kernel,
+and only a small ShmFrameMsg descriptor (offset, length, generation) travels through MsgSend().
+
+ Variable-Length Messages (MsgSendv / MsgReplyv)
+By default the client sends MSG_RECORD: a 16-byte MsgHeader and the 14 bytes of "Hello, Server!",
+gathered from two buffers with SETIOV, instead of a padded 104-byte Message. The server replies the same way.
+Use -r <bytes> to send a large record (the server pulls the rest with MsgRead()),
+or -f for the original fixed-size Message.
+
+ Multi-Threaded Server (-t <threads>)
+With one receive thread, a slow request stalls every other client. With -t N the server runs N threads
+that all block in MsgReceive() on the same chid; the kernel gives each incoming message to one idle thread,
+so N requests are served in parallel across cores. This is the fixed-size form of thread_pool_create().
+Handlers are looked up by msg_type in dispatch_table (register_handler()), so adding a message type
+does not touch the receive loop.
+
+ Pulses and Completion Events (-p <count>, -j)
+MsgSend() costs a full send/receive/reply round trip and two context switches even when the client
+does not need an answer. A pulse (MsgSendPulse()) is queued by the kernel and the sender continues
+immediately; the server recognises it by rcvid == 0 and never replies.
+For work that does need a result, the client sends a sigevent with the request. The server replies
+at once, finishes the job later and calls MsgDeliverEvent(), which arrives as a pulse on the client's channel.
+
+ Name-Based Discovery and Connection Caching (-n <name>)
+Connecting to pid 0 / chid 1 only works if the server happens to get channel 1 in a known process.
+The server registers a name with name_attach() instead (so several instances can run under different
+names), and the client resolves it with name_open(). IpcConnection keeps the coid for reuse; when a send
+fails with EBADF/ESRCH because the server restarted, ipc_connection_recover() reopens the name and the
+request is retried. Disconnect pulses let the server clean up shared memory left by clients that exit.
+
+ Cross-Node IPC over Qnet (-N <node> -i <pid> -c <chid>, -b <count>)
+With Qnet the same MsgSend() reaches a server on another node: netmgr_strtond() turns the node name into
+a node descriptor, and ConnectAttach(nd, pid, chid) uses the pid/chid the server prints at startup.
+Each message to another node costs a network round trip, so -b packs many short records into MSG_BATCH
+messages (up to IPC_BATCH_MAX_BYTES each) and the server answers each batch with one BatchReply.
+
+ Real-Time Server Mode (server -F -P <prio>, client -d <us>)
+By default a receive thread inherits the priority of the client it is serving, and send-blocked clients
+are queued by priority, so a high-priority client is not stuck behind a low-priority one's request.
+-F creates the channel with _NTO_CHF_FIXED_PRIORITY instead: receive threads keep the priority set with -P,
+which bounds how far a flood of client requests can push the server around.
+A record can carry an absolute deadline (client -d). If it has already passed when the server receives
+the request, the server answers with MsgError(ETIMEDOUT) at once instead of processing it late.*/
@@ -1,4 +1,15 @@
+#include <iostream>
 #include <memory> // Required for smart pointers
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define ALLOC_TRACKING_REPLACE_GLOBAL_NEW  // Count every heap allocation in this program (see alloc_tracking.hpp)
+#include "alloc_tracking.hpp"
+#include "epoch_reclaim.hpp"
+#include "local_ref_ptr.hpp"
+#include "pool_allocator.hpp"
 
 void uniquePtrExample() {
     std::unique_ptr<int> ptr = std::make_unique<int>(10); // No need to delete
@@ -20,3 +31,151 @@ void weakPtrExample() {
     std::shared_ptr<int> shared = std::make_shared<int>(20);
     std::weak_ptr<int> weak = shared; // Doesn't increase reference count
 } // `shared` deletes memory; `weak` doesn't prevent deletion
+
+// Readers share a large config without touching a reference count; old versions are freed in the background
+struct ControlConfig {
+    int version;
+    std::vector<double> gains;  // Large: copying or freeing it is what the writer should not pay for in-line
+};
+
+void rcuConfigExample() {
+    EpochDomain domain;
+    RcuCell<ControlConfig> config(domain,
+                                  std::make_unique<ControlConfig>(ControlConfig{0, std::vector<double>(4096, 0.0)}));
+    std::atomic<bool> running(true);
+    std::atomic<long> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            EpochDomain::Reader reader = domain.registerReader();
+            long n = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                auto guard = reader.enter();
+                const ControlConfig* current = config.get(guard); // No refcount, no lock
+                if (current->gains[n & 4095] == current->version) ++n; // Always a consistent version
+            }
+            reads += n;
+        });
+    }
+    for (int version = 1; version <= 50; ++version) {
+        config.update(std::make_unique<ControlConfig>(ControlConfig{version, std::vector<double>(4096, version)}));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    running = false;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    std::cout << "RCU config: " << reads << " reads, " << domain.retiredCount() << " versions retired, "
+              << domain.freedCount() << " freed so far by the background thread" << std::endl;
+} // The domain frees whatever is still retired
+
+// Same sharing as sharedPtrExample(), but the count lives in the object and is not atomic
+struct Waypoint : LocalRefCounted {
+    double x, y;
+    Waypoint(double px, double py) : x(px), y(py) {}
+};
+
+void localRefPtrExample() {
+    local_ref_ptr<Waypoint> ptr1 = make_local_ref<Waypoint>(1.0, 2.0);
+    local_ref_ptr<Waypoint> ptr2 = ptr1; // Plain increment, no locked instruction
+
+    std::cout << "Local count: " << ptr1.use_count() << std::endl; // 2
+} // Deleted when the last local_ref_ptr goes; only valid while the object stays on one thread
+
+// Real-time variants: same ownership rules, but no heap calls once the pools exist
+struct Command {
+    int actuator;
+    double setpoint;
+};
+
+void pooledPtrExample() {
+    // Startup: reserve everything the loop will ever need
+    FixedBlockPool commandPool(sizeof(Command), 32);
+    FixedBlockPool sharedPool(sharedBlockSize<Command>(), 32);  // Command + shared_ptr control block
+    MonotonicArena scratch(4096);
+
+    // unique_ptr whose deleter returns the block to commandPool
+    {
+        PooledPtr<Command> cmd = makePooled<Command>(commandPool, Command{3, 0.5});
+        std::cout << "Pooled unique_ptr: actuator " << cmd->actuator << ", " << commandPool.available()
+                  << " blocks left" << std::endl;
+    } // Destroyed and returned to the pool, O(1)
+
+    // allocate_shared: object and control block live in one pool block
+    std::shared_ptr<Command> shared =
+        std::allocate_shared<Command>(PoolAllocator<Command>(sharedPool), Command{7, 1.25});
+    std::shared_ptr<Command> copy = shared;
+    std::cout << "Pooled shared_ptr count: " << shared.use_count() << ", " << sharedPool.available()
+              << " blocks left" << std::endl;
+
+    // Per-cycle scratch objects from the arena, all released by one reset()
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        {
+            auto temp = std::allocate_shared<double>(ArenaAllocator<double>(scratch), cycle * 0.1);
+        }
+        scratch.reset();  // Only once nothing from this cycle is alive any more
+    }
+    std::cout << "Arena used after reset: " << scratch.used() << " bytes" << std::endl;
+}
+
+// Proof instead of assumption: is the loop below really allocation-free?
+void trackedAllocationExample() {
+    std::uint64_t loopHeap;
+    double sum = 0;
+    {
+        // Startup: allocations are expected here
+        std::shared_ptr<ControlConfig> config =
+            makeTrackedShared<ControlConfig>(ControlConfig{1, std::vector<double>(256, 1.0)});
+        TrackedPtr<Waypoint> home = makeTrackedUnique<Waypoint>(0.0, 0.0);
+        FixedBlockPool commandPool(sizeof(Command), 16);
+
+        allocationTracker().enterSteadyState();
+        for (int cycle = 0; cycle < 1000; ++cycle) {
+            PooledPtr<Command> cmd = makePooled<Command>(commandPool, Command{cycle & 7, config->gains[cycle & 255]});
+            sum += cmd->setpoint; // Pool only: no heap call
+        }
+        loopHeap = allocationTracker().steadyStateHeapAllocations();
+        TrackedPtr<Waypoint> stray = makeTrackedUnique<Waypoint>(1.0, 1.0); // A bug: flagged in the report
+        allocationTracker().leaveSteadyState();
+    } // Frees are recorded too
+
+    std::cout << "Steady-state loop: " << loopHeap << " heap allocations (sum " << sum << ")" << std::endl;
+    printAllocationReport();
+}
+
+int main() {
+    uniquePtrExample();
+    sharedPtrExample();
+    weakPtrExample();
+    rcuConfigExample();
+    localRefPtrExample();
+    pooledPtrExample();
+    trackedAllocationExample();
+}
+
+/*Why pools for smart pointers?
+make_unique/make_shared ask the global heap for memory on every call, and malloc latency depends on
+the heap's state: usually fast, occasionally very slow, and the heap fragments over time.
+A FixedBlockPool is filled once at startup; after that an allocation is a free-list pop and a free is
+a push, so the worst case is known. The smart pointers still own and free the objects as usual:
+PoolDeleter puts a unique_ptr's object back in its pool, and allocate_shared with PoolAllocator
+puts a shared_ptr's object and its reference counts into a single pool block.
+
+Why epochs instead of shared_ptr for shared configuration?
+With shared_ptr every read is an atomic increment and decrement on one count shared by all readers,
+and whoever drops the last copy runs the destructor in-line. EpochDomain readers only announce an epoch
+in their own cache line; the writer retires old versions and a background thread frees them in batches
+once no reader can still be using them.
+
+Why track allocations?
+A real-time loop must not call the heap, but one std::string or std::function inside it is enough
+to break that silently. alloc_tracking.hpp books every tracked smart-pointer allocation per type
+(counts, bytes, peak, latency) and, with the global operator new replaced, counts every heap call made
+after enterSteadyState(): the report shows 0 for the pooled loop and flags the stray allocation.
+
+Why local_ref_ptr?
+Every shared_ptr copy is an atomic increment, because another thread might hold a copy too.
+For objects that never leave their thread, local_ref_ptr keeps a plain counter inside the object:
+copies are ordinary increments and the pointer is one word. atomic_ref_ptr has the same interface with
+an atomic counter, for the objects that do cross threads. ref_ptr_benchmark.cpp measures the difference.*/
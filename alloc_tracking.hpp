@@ -0,0 +1,300 @@
+/*Allocation Tracking - Counts, Bytes, Peaks and Latency per Type, and a Steady-State Alarm
+"The control loop does not allocate" is usually an assumption. This opt-in layer turns it into
+a measurement:
+TrackingAllocator<T>       - wraps an allocator (std::allocator by default); use it with
+                             std::allocate_shared, containers, or PoolAllocator from pool_allocator.hpp.
+makeTrackedUnique<T>(...)  - unique_ptr with a TrackingDeleter that times destruction + free.
+makeTrackedShared<T>(...)  - allocate_shared through a TrackingAllocator.
+Each records, per tracked type: allocations, frees, live and peak bytes, and allocation / free latency
+in LatencyHistograms. Control blocks are booked under the object's type (the Tag parameter survives
+allocator rebinding), so allocate_shared<Foo> shows up as Foo.
+
+allocationTracker().enterSteadyState() marks the end of startup. Every tracked allocation after it is
+flagged. To catch untracked heap use too (std::string, std::function, third-party code), define
+ALLOC_TRACKING_REPLACE_GLOBAL_NEW in exactly one .cpp before including this header: that replaces
+the global operator new/delete (all forms, aligned ones included) with counting versions that flag
+every allocation after the marker.
+printAllocationReport() prints the per-type table and the steady-state verdict.*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <typeinfo>
+#include <utility>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include "latency_histogram.hpp"
+
+// Statistics of one tracked type; lives as long as the program
+struct AllocationStats {
+    const char* name = nullptr;
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t totalBytes = 0;
+    std::uint64_t liveBytes = 0;
+    std::uint64_t peakBytes = 0;
+    std::uint64_t steadyStateAllocations = 0;
+    LatencyHistogram allocNs;
+    LatencyHistogram freeNs;
+    std::mutex mutex;                 // Recording may happen on any thread
+    AllocationStats* next = nullptr;  // Intrusive registry list: registering a type never allocates
+};
+
+class AllocationTracker {
+public:
+    void enterSteadyState() { steady_.store(true, std::memory_order_release); }
+    void leaveSteadyState() { steady_.store(false, std::memory_order_release); }
+    bool inSteadyState() const { return steady_.load(std::memory_order_acquire); }
+
+    // Heap allocations seen by the replaced global operator new after the marker (0 if not replaced)
+    std::uint64_t steadyStateHeapAllocations() const { return heapAfterSteady_.load(std::memory_order_relaxed); }
+    std::uint64_t heapAllocations() const { return heapAllocations_.load(std::memory_order_relaxed); }
+    bool globalNewReplaced() const { return globalNewReplaced_.load(std::memory_order_relaxed); }
+
+    void recordAlloc(AllocationStats& stats, std::size_t bytes, std::int64_t ns) {
+        bool steady = inSteadyState();
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        stats.allocations++;
+        stats.totalBytes += bytes;
+        stats.liveBytes += bytes;
+        if (stats.liveBytes > stats.peakBytes) stats.peakBytes = stats.liveBytes;
+        stats.allocNs.record(ns);
+        if (steady) stats.steadyStateAllocations++;
+    }
+
+    void recordFree(AllocationStats& stats, std::size_t bytes, std::int64_t ns) {
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        stats.frees++;
+        stats.liveBytes -= bytes;
+        stats.freeNs.record(ns);
+    }
+
+    void registerType(AllocationStats& stats) {
+        stats.next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(stats.next, &stats, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    AllocationStats* types() const { return head_.load(std::memory_order_acquire); }
+
+    // Called by the replacement operator new (ALLOC_TRACKING_REPLACE_GLOBAL_NEW)
+    void noteHeapAllocation() {
+        heapAllocations_.fetch_add(1, std::memory_order_relaxed);
+        if (inSteadyState()) heapAfterSteady_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void noteGlobalNewReplaced() { globalNewReplaced_.store(true, std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> steady_{false};
+    std::atomic<AllocationStats*> head_{nullptr};
+    std::atomic<std::uint64_t> heapAllocations_{0};
+    std::atomic<std::uint64_t> heapAfterSteady_{0};
+    std::atomic<bool> globalNewReplaced_{false};
+};
+
+// Constant-initialized, so it is usable from operator new before any constructor has run
+inline AllocationTracker& allocationTracker() {
+    static constinit AllocationTracker tracker;
+    return tracker;
+}
+
+namespace alloc_tracking_detail {
+
+inline std::int64_t elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Demangled once on first use; the buffer is intentionally never freed (it lives as long as the stats)
+template <typename T>
+const char* typeName() {
+#if defined(__GNUG__)
+    int status = 0;
+    char* name = abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status);
+    return status == 0 && name ? name : typeid(T).name();
+#else
+    return typeid(T).name();
+#endif
+}
+
+}  // namespace alloc_tracking_detail
+
+template <typename Tag>
+AllocationStats& allocationStats() {
+    static AllocationStats stats;
+    static const bool registered = [] {
+        stats.name = alloc_tracking_detail::typeName<Tag>();
+        allocationTracker().registerType(stats);
+        return true;
+    }();
+    (void)registered;
+    return stats;
+}
+
+template <typename T, typename Inner = std::allocator<T>, typename Tag = T>
+class TrackingAllocator {
+    using InnerTraits = std::allocator_traits<Inner>;
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackingAllocator<U, typename InnerTraits::template rebind_alloc<U>, Tag>;
+    };
+
+    TrackingAllocator() = default;
+    explicit TrackingAllocator(const Inner& inner) : inner_(inner) {}
+    template <typename U, typename OtherInner>
+    TrackingAllocator(const TrackingAllocator<U, OtherInner, Tag>& other) : inner_(other.inner()) {}
+
+    T* allocate(std::size_t n) {
+        auto start = std::chrono::steady_clock::now();
+        T* p = InnerTraits::allocate(inner_, n);
+        std::int64_t ns = alloc_tracking_detail::elapsedNs(start);
+        allocationTracker().recordAlloc(allocationStats<Tag>(), n * sizeof(T), ns);
+        return p;
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        auto start = std::chrono::steady_clock::now();
+        InnerTraits::deallocate(inner_, p, n);
+        std::int64_t ns = alloc_tracking_detail::elapsedNs(start);
+        allocationTracker().recordFree(allocationStats<Tag>(), n * sizeof(T), ns);
+    }
+
+    const Inner& inner() const { return inner_; }
+
+    template <typename U, typename OtherInner>
+    bool operator==(const TrackingAllocator<U, OtherInner, Tag>& other) const {
+        return inner_ == other.inner();
+    }
+
+private:
+    Inner inner_;
+};
+
+// Times the destructor and the free together: that is what the owner pays when the pointer goes away
+template <typename T, typename Inner = std::default_delete<T>>
+struct TrackingDeleter {
+    Inner inner;
+
+    void operator()(T* p) const {
+        auto start = std::chrono::steady_clock::now();
+        inner(p);
+        allocationTracker().recordFree(allocationStats<T>(), sizeof(T), alloc_tracking_detail::elapsedNs(start));
+    }
+};
+
+template <typename T>
+using TrackedPtr = std::unique_ptr<T, TrackingDeleter<T>>;
+
+template <typename T, typename... Args>
+TrackedPtr<T> makeTrackedUnique(Args&&... args) {
+    auto start = std::chrono::steady_clock::now();
+    T* p = new T(std::forward<Args>(args)...);
+    allocationTracker().recordAlloc(allocationStats<T>(), sizeof(T), alloc_tracking_detail::elapsedNs(start));
+    return TrackedPtr<T>(p);
+}
+
+template <typename T, typename... Args>
+std::shared_ptr<T> makeTrackedShared(Args&&... args) {
+    return std::allocate_shared<T>(TrackingAllocator<T>(), std::forward<Args>(args)...);
+}
+
+inline void printAllocationReport(std::FILE* out = stdout) {
+    std::fprintf(out, "%-24s %8s %8s %10s %10s %9s %9s %9s %7s\n", "type", "allocs", "frees", "live B", "peak B",
+                 "alloc p99", "alloc max", "free p99", "steady");
+    for (AllocationStats* s = allocationTracker().types(); s; s = s->next) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        std::fprintf(out, "%-24.24s %8llu %8llu %10llu %10llu %7.2fus %7.2fus %7.2fus %7llu\n", s->name,
+                     static_cast<unsigned long long>(s->allocations), static_cast<unsigned long long>(s->frees),
+                     static_cast<unsigned long long>(s->liveBytes), static_cast<unsigned long long>(s->peakBytes),
+                     s->allocNs.percentile(99) / 1e3, s->allocNs.max() / 1e3, s->freeNs.percentile(99) / 1e3,
+                     static_cast<unsigned long long>(s->steadyStateAllocations));
+    }
+    AllocationTracker& tracker = allocationTracker();
+    if (tracker.globalNewReplaced()) {
+        std::fprintf(out, "heap: %llu operator new calls, %llu after the steady-state marker\n",
+                     static_cast<unsigned long long>(tracker.heapAllocations()),
+                     static_cast<unsigned long long>(tracker.steadyStateHeapAllocations()));
+    }
+}
+
+#ifdef ALLOC_TRACKING_REPLACE_GLOBAL_NEW
+// Replacement global allocation functions: count every heap allocation, flag those after the marker.
+// Defined in the one translation unit that sets the macro; they must not be inline.
+// noinline keeps GCC from pairing the inlined malloc/free with new/delete call sites (-Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(std::size_t bytes) {
+    AllocationTracker& tracker = allocationTracker();
+    tracker.noteGlobalNewReplaced();
+    tracker.noteHeapAllocation();
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void* operator new[](std::size_t bytes) { return operator new(bytes); }
+__attribute__((noinline)) void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(bytes);
+    } catch (...) {
+        return nullptr;
+    }
+}
+__attribute__((noinline)) void* operator new[](std::size_t bytes, const std::nothrow_t& tag) noexcept {
+    return operator new(bytes, tag);
+}
+// Over-aligned types (alignas(64) CachePadded, FixedBlockPool storage) come through these
+__attribute__((noinline)) void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    AllocationTracker& tracker = allocationTracker();
+    tracker.noteGlobalNewReplaced();
+    tracker.noteHeapAllocation();
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (bytes ? bytes + align - 1 : align) / align * align;  // aligned_alloc wants a multiple
+    if (rounded >= bytes) {
+        if (void* p = std::aligned_alloc(align, rounded)) return p;
+    }
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void* operator new[](std::size_t bytes, std::align_val_t alignment) {
+    return operator new(bytes, alignment);
+}
+__attribute__((noinline)) void* operator new(std::size_t bytes, std::align_val_t alignment,
+                                             const std::nothrow_t&) noexcept {
+    try {
+        return operator new(bytes, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+__attribute__((noinline)) void* operator new[](std::size_t bytes, std::align_val_t alignment,
+                                               const std::nothrow_t& tag) noexcept {
+    return operator new(bytes, alignment, tag);
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+__attribute__((noinline)) void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+#endif
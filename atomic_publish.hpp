@@ -0,0 +1,64 @@
+/*PublishedValue<T, Order> - Publish/Consume with an Explicit Memory Order
+Plain sensorData.load() / sensorData.store() default to std::memory_order_seq_cst.
+That is the strongest (and slowest) ordering: on x86 every store becomes an XCHG, and on ARM
+every load and store needs acquire/release instructions plus extra barriers around them.
+
+A single producer publishing a value to consumers only needs release on the store and acquire on the load:
+everything the writer did before publish() is visible to a reader whose consume() sees that value.
+
+The writer's "load, add delta, store" is also not atomic: a second writer could slip in between.
+update() uses fetch_add so the read-modify-write is one indivisible operation.
+
+Order is a template parameter so the same code can be benchmarked with:
+std::memory_order_seq_cst - total order across all threads (the default behaviour),
+std::memory_order_acq_rel - release stores, acquire loads, acq_rel read-modify-writes,
+std::memory_order_relaxed - atomicity only, no ordering of surrounding memory.*/
+
+#pragma once
+
+#include <atomic>
+
+namespace memory_order_policy {
+
+constexpr std::memory_order loadOrder(std::memory_order order) {
+    return order == std::memory_order_acq_rel ? std::memory_order_acquire : order;
+}
+
+constexpr std::memory_order storeOrder(std::memory_order order) {
+    return order == std::memory_order_acq_rel ? std::memory_order_release : order;
+}
+
+}  // namespace memory_order_policy
+
+template <typename T, std::memory_order Order = std::memory_order_acq_rel>
+class PublishedValue {
+    static_assert(Order == std::memory_order_seq_cst || Order == std::memory_order_acq_rel ||
+                  Order == std::memory_order_relaxed,
+                  "PublishedValue supports seq_cst, acq_rel and relaxed");
+
+public:
+    static constexpr std::memory_order kLoadOrder = memory_order_policy::loadOrder(Order);
+    static constexpr std::memory_order kStoreOrder = memory_order_policy::storeOrder(Order);
+    static constexpr std::memory_order kUpdateOrder = Order;
+
+    constexpr PublishedValue() : value_() {}
+    constexpr explicit PublishedValue(T initial) : value_(initial) {}
+
+    // Writer side: make a new value visible to consumers
+    void publish(T value) {
+        value_.store(value, kStoreOrder);
+    }
+
+    // Writer side: atomically add delta, returns the new value
+    T update(T delta) {
+        return value_.fetch_add(delta, kUpdateOrder) + delta;
+    }
+
+    // Reader side: latest published value
+    T consume() const {
+        return value_.load(kLoadOrder);
+    }
+
+private:
+    std::atomic<T> value_;
+};
@@ -0,0 +1,418 @@
+/*Benchmark Suite - Every Example's Hot Path in One Google Benchmark Binary
+The *_benchmark.cpp programs each time one question by hand and print a table. This suite puts the
+hot paths of all examples under Google Benchmark, so they are measured the same way (warm-up, repetitions,
+statistics) and the results can be stored as JSON and compared release to release:
+Sensor channels  - std::atomic<int> as in 2_const_volatile_atomic.cpp, PublishedValue<T, Order> per memory order,
+                   SensorChannel<T> with and without a concurrent writer (thread 0 writes, the others read)
+Logger counters  - the access counter of 3_mutable.cpp as a plain int, one shared atomic and a ShardedCounter,
+                   plus the LogSink path of Logger::showMessage(), accepted and ring-full lines separately
+Smart pointers   - the allocation modes of Unique_ptr.cpp: heap, FixedBlockPool, MonotonicArena, and copies of
+                   shared_ptr / local_ref_ptr / atomic_ref_ptr
+RT executor      - release jitter of a PeriodicExecutor task (p50/p99/max as counters, in ns)
+Indicator engine - the fused filter mask and the streaming update of indicator_engine.hpp
+QNX IPC (QNX only, needs a running QNX_ipc server; its name from QNX_IPC_SERVER, default IPC_SERVER_NAME)
+                 - MsgSend() of the fixed Message, header + payload records, and pulses
+
+Usage: ./benchmark_suite --benchmark_out=results.json --benchmark_out_format=json [--benchmark_filter=Sensor]
+(the CMake target benchmark_json does this and writes benchmark_results.json into the build directory).
+Compare two result files with tools/compare.py from the Google Benchmark sources.*/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "atomic_publish.hpp"
+#include "indicator_engine.hpp"
+#include "local_ref_ptr.hpp"
+#include "log_sink.hpp"
+#include "pool_allocator.hpp"
+#include "rt_executor.hpp"
+#include "sensor_channel.hpp"
+#include "sharded_counter.hpp"
+
+#ifdef __QNX__
+#include "qnx_ipc.h"
+#endif
+
+// ----- Sensor channels -----
+
+struct SensorSample {
+    int value;
+    std::int64_t timestamp;
+    std::uint64_t sequence;
+    int checksum;
+};
+
+static void BM_AtomicIntPublish(benchmark::State& state) {
+    static std::atomic<int> sensorData{25};
+    int value = 25;
+    for (auto _ : state) {
+        sensorData.store(value++);  // seq_cst, as in the atomic version of 2_const_volatile_atomic.cpp
+    }
+}
+BENCHMARK(BM_AtomicIntPublish);
+
+static void BM_AtomicIntRead(benchmark::State& state) {
+    static std::atomic<int> sensorData{25};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sensorData.load());
+    }
+}
+BENCHMARK(BM_AtomicIntRead)->ThreadRange(1, 8);
+
+// Thread 0 publishes with update(), the others consume
+template <std::memory_order Order>
+static void BM_PublishedValue(benchmark::State& state) {
+    static PublishedValue<int, Order> sensorData(25);
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            benchmark::DoNotOptimize(sensorData.update(1));
+        } else {
+            benchmark::DoNotOptimize(sensorData.consume());
+        }
+    }
+}
+BENCHMARK_TEMPLATE(BM_PublishedValue, std::memory_order_seq_cst)->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(BM_PublishedValue, std::memory_order_acq_rel)->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(BM_PublishedValue, std::memory_order_relaxed)->ThreadRange(1, 4);
+
+static void BM_SensorChannelPublish(benchmark::State& state) {
+    SensorChannel<SensorSample> channel(SensorSample{25, 0, 0, 25});
+    std::uint64_t sequence = 0;
+    for (auto _ : state) {
+        ++sequence;
+        channel.publish(SensorSample{25, std::int64_t(sequence), sequence, int(25 ^ sequence)});
+    }
+}
+BENCHMARK(BM_SensorChannelPublish);
+
+// Readers only: the seqlock read path when nothing is being written
+static void BM_SensorChannelRead(benchmark::State& state) {
+    static SensorChannel<SensorSample> channel(SensorSample{25, 0, 0, 25});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(channel.read());
+    }
+}
+BENCHMARK(BM_SensorChannelRead)->ThreadRange(1, 8);
+
+// Thread 0 publishes continuously; reads retry when they overlap a publish
+static void BM_SensorChannelReadWithWriter(benchmark::State& state) {
+    static SensorChannel<SensorSample> channel(SensorSample{25, 0, 0, 25});
+    std::uint64_t sequence = 0;
+    std::int64_t torn = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            ++sequence;
+            channel.publish(SensorSample{25, std::int64_t(sequence), sequence, int(25 ^ sequence)});
+        } else {
+            SensorSample sample = channel.read();
+            torn += sample.checksum != int(sample.value ^ sample.sequence);
+        }
+    }
+    state.counters["torn"] = benchmark::Counter(double(torn), benchmark::Counter::kAvgThreads);  // Must stay 0
+}
+BENCHMARK(BM_SensorChannelReadWithWriter)->Threads(2)->Threads(4)->Threads(8);
+
+// ----- Logger counters (3_mutable.cpp) -----
+
+static void BM_CounterPlainInt(benchmark::State& state) {
+    int accessCount = 0;  // The original mutable int: only correct on one thread
+    for (auto _ : state) {
+        ++accessCount;
+        benchmark::ClobberMemory();
+    }
+    benchmark::DoNotOptimize(accessCount);
+}
+BENCHMARK(BM_CounterPlainInt);
+
+static void BM_CounterSharedAtomic(benchmark::State& state) {
+    static std::atomic<std::uint64_t> accessCount{0};  // One cache line for every thread
+    for (auto _ : state) {
+        accessCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+BENCHMARK(BM_CounterSharedAtomic)->ThreadRange(1, 8);
+
+static void BM_CounterSharded(benchmark::State& state) {
+    static ShardedCounter<> accessCount;
+    for (auto _ : state) {
+        ++accessCount;
+    }
+    if (state.thread_index() == 0) benchmark::DoNotOptimize(accessCount.value());
+}
+BENCHMARK(BM_CounterSharded)->ThreadRange(1, 8);
+
+// The body of showMessage() with a sink, inlined (3_mutable.cpp has its own main()): counter increment plus a
+// queued line; the flusher writes to /dev/null. "dropped" is the per-thread average for this run only.
+// Accepted lines: a run is kLoggerLines lines per thread, which fit in the ring even if the flusher never
+// runs, so the timing is the queuing path and dropped stays 0
+constexpr std::int64_t kLoggerLines = 1 << 16;
+
+static void BM_LoggerShowMessage(benchmark::State& state) {
+    static int devNull = ::open("/dev/null", O_WRONLY);
+    static LogSink sink(devNull, 4 * 1024 * 1024);  // 4 MiB > kLoggerLines * ~40 bytes
+    static ShardedCounter<> accessCount;
+    std::int64_t dropped = 0;
+    for (auto _ : state) {
+        ++accessCount;
+        if (!sink.log("Hello, world! (Accessed ", accessCount.value(), " times)\n")) ++dropped;
+    }
+    state.counters["dropped"] = benchmark::Counter(double(dropped), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_LoggerShowMessage)->Iterations(kLoggerLines)->ThreadRange(1, 4);
+
+// Rejected lines: a 4 KiB ring drained once a second is full after a few hundred lines, so this times the
+// ring-full path a producer hits when it outruns the flusher
+static void BM_LoggerShowMessageRingFull(benchmark::State& state) {
+    static int devNull = ::open("/dev/null", O_WRONLY);
+    static LogSink sink(devNull, 4 * 1024, std::chrono::seconds(1));
+    static ShardedCounter<> accessCount;
+    std::int64_t dropped = 0;
+    for (auto _ : state) {
+        ++accessCount;
+        if (!sink.log("Hello, world! (Accessed ", accessCount.value(), " times)\n")) ++dropped;
+    }
+    state.counters["dropped"] = benchmark::Counter(double(dropped), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_LoggerShowMessageRingFull)->ThreadRange(1, 4);
+
+// ----- Smart-pointer allocation modes (Unique_ptr.cpp) -----
+
+struct Command {
+    int actuator;
+    double setpoint;
+};
+
+struct LocalCommand : LocalRefCounted {
+    int actuator = 1;
+    double setpoint = 0.5;
+};
+
+struct AtomicCommand : AtomicRefCounted {
+    int actuator = 1;
+    double setpoint = 0.5;
+};
+
+static void BM_MakeUnique(benchmark::State& state) {
+    for (auto _ : state) {
+        auto cmd = std::make_unique<Command>(Command{3, 0.5});
+        benchmark::DoNotOptimize(cmd.get());
+    }
+}
+BENCHMARK(BM_MakeUnique);
+
+static void BM_MakeShared(benchmark::State& state) {
+    for (auto _ : state) {
+        auto cmd = std::make_shared<Command>(Command{3, 0.5});
+        benchmark::DoNotOptimize(cmd.get());
+    }
+}
+BENCHMARK(BM_MakeShared);
+
+static void BM_PooledUnique(benchmark::State& state) {
+    FixedBlockPool pool(sizeof(Command), 32);
+    for (auto _ : state) {
+        PooledPtr<Command> cmd = makePooled<Command>(pool, Command{3, 0.5});
+        benchmark::DoNotOptimize(cmd.get());
+    }
+}
+BENCHMARK(BM_PooledUnique);
+
+static void BM_PooledShared(benchmark::State& state) {
+    FixedBlockPool pool(sharedBlockSize<Command>(), 32);
+    for (auto _ : state) {
+        auto cmd = std::allocate_shared<Command>(PoolAllocator<Command>(pool), Command{3, 0.5});
+        benchmark::DoNotOptimize(cmd.get());
+    }
+}
+BENCHMARK(BM_PooledShared);
+
+// Per-cycle scratch: 64 allocations, then one reset()
+static void BM_ArenaShared(benchmark::State& state) {
+    MonotonicArena scratch(64 * 1024);
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i) {
+            auto temp = std::allocate_shared<double>(ArenaAllocator<double>(scratch), i * 0.1);
+            benchmark::DoNotOptimize(temp.get());
+        }
+        scratch.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_ArenaShared);
+
+// Assigns a pointer into a ring slot: one increment, and one decrement of the pointer it replaces.
+// Two sources over an odd-sized ring, so a slot never receives the pointer it already holds.
+template <typename Ptr>
+static void copyIntoRing(benchmark::State& state, const Ptr& first, const Ptr& second) {
+    std::vector<Ptr> ring(63);
+    std::size_t slot = 0;
+    bool odd = false;
+    for (auto _ : state) {
+        ring[slot] = odd ? second : first;
+        odd = !odd;
+        slot = slot == 62 ? 0 : slot + 1;
+        benchmark::ClobberMemory();
+    }
+}
+
+static void BM_CopySharedPtr(benchmark::State& state) {
+    copyIntoRing(state, std::make_shared<Command>(Command{3, 0.5}), std::make_shared<Command>(Command{4, 0.5}));
+}
+BENCHMARK(BM_CopySharedPtr);
+
+static void BM_CopyLocalRefPtr(benchmark::State& state) {
+    copyIntoRing(state, make_local_ref<LocalCommand>(), make_local_ref<LocalCommand>());
+}
+BENCHMARK(BM_CopyLocalRefPtr);
+
+static void BM_CopyAtomicRefPtr(benchmark::State& state) {
+    copyIntoRing(state, make_atomic_ref<AtomicCommand>(), make_atomic_ref<AtomicCommand>());
+}
+BENCHMARK(BM_CopyAtomicRefPtr);
+
+// ----- RT executor jitter -----
+
+// One task with period state.range(0) us, run for half a second (one iteration); jitter counters are in ns.
+// Run as root for SCHED_FIFO; without privileges the numbers are those of SCHED_OTHER.
+static void BM_PeriodicExecutorJitter(benchmark::State& state) {
+    TaskConfig config;
+    config.policy = SCHED_FIFO;
+    config.priority = 80;
+    PeriodicExecutor executor(90);
+    executor.addTask("jitter", std::chrono::microseconds(state.range(0)), std::chrono::nanoseconds(0), [] {}, config);
+    for (auto _ : state) {
+        executor.run(std::chrono::milliseconds(500));
+    }
+    const TaskStats& stats = executor.tasks().front()->stats;
+    state.counters["releases"] = double(stats.releases);
+    state.counters["deadline_misses"] = double(stats.deadlineMisses);
+    state.counters["jitter_p50_ns"] = double(stats.jitter.percentile(50));
+    state.counters["jitter_p99_ns"] = double(stats.jitter.percentile(99));
+    state.counters["jitter_max_ns"] = double(stats.jitter.max());
+    state.counters["wcet_ns"] = double(stats.execution.max());
+}
+BENCHMARK(BM_PeriodicExecutorJitter)->Arg(1000)->Arg(250)->Iterations(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// ----- Indicator engine -----
+
+static std::vector<double> syntheticCloses(std::size_t n) {
+    std::vector<double> close(n);
+    double price = 100;
+    for (std::size_t i = 0; i < n; ++i) {
+        price += std::sin(double(i) * 0.05) + ((i * 2654435761u) % 1000) / 1000.0 - 0.5;
+        close[i] = price;
+    }
+    return close;
+}
+
+static void BM_IndicatorFilterMask(benchmark::State& state) {
+    const std::vector<double> close = syntheticCloses(std::size_t(state.range(0)));
+    std::vector<std::uint8_t> mask(close.size());
+    IndicatorParams params;
+    for (auto _ : state) {
+        computeFilterMask(close.data(), close.size(), params, mask.data());
+        benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(kernelName());
+}
+BENCHMARK(BM_IndicatorFilterMask)->Arg(1 << 12)->Arg(1 << 20);
+
+static void BM_IndicatorStreamUpdate(benchmark::State& state) {
+    const std::vector<double> close = syntheticCloses(4096);
+    StreamingFilters stream{IndicatorParams{}};
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stream.update(close[i]));
+        i = (i + 1) & 4095;
+    }
+}
+BENCHMARK(BM_IndicatorStreamUpdate);
+
+// ----- QNX IPC -----
+
+#ifdef __QNX__
+
+static const char* ipcServerName() {
+    const char* name = std::getenv("QNX_IPC_SERVER");
+    return name ? name : IPC_SERVER_NAME;
+}
+
+// Runs send(coid) per iteration over one connection to the server
+template <typename Send>
+static void ipcRoundTrips(benchmark::State& state, Send&& send) {
+    IpcConnection conn;
+    ipc_connection_init(&conn, ipcServerName());
+    int coid = ipc_connection_coid(&conn);
+    if (coid == -1) {
+        state.SkipWithError("cannot connect to the QNX_ipc server (start it with -q; name from QNX_IPC_SERVER)");
+        return;
+    }
+    for (auto _ : state) {
+        if (send(coid) == -1) {
+            state.SkipWithError("send failed");
+            break;
+        }
+    }
+    ipc_connection_close(&conn);
+}
+
+static void BM_QnxMsgSendFixed(benchmark::State& state) {
+    Message request;
+    Message reply;
+    request.msg_type = MSG_TEXT;
+    strcpy(request.text, "Hello, Server!");
+    ipcRoundTrips(state, [&](int coid) { return MsgSend(coid, &request, sizeof(request), &reply, sizeof(reply)); });
+    state.SetBytesProcessed(state.iterations() * std::int64_t(sizeof(Message)));
+}
+BENCHMARK(BM_QnxMsgSendFixed)->ThreadRange(1, 4)->UseRealTime();
+
+static void BM_QnxMsgSendRecord(benchmark::State& state) {
+    std::vector<unsigned char> payload(std::size_t(state.range(0)), 0x5a);
+    std::vector<unsigned char> reply(payload.size());
+    ipcRoundTrips(state, [&](int coid) {
+        return ipc_send_record(coid, MSG_RECORD, payload.data(), uint32_t(payload.size()), reply.data(),
+                               uint32_t(reply.size()));
+    });
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QnxMsgSendRecord)->Arg(16)->Arg(256)->Arg(4096)->Arg(65536)->UseRealTime();
+
+// One-way: the send cost only, the server never replies to a pulse
+static void BM_QnxPulse(benchmark::State& state) {
+    ipcRoundTrips(state, [](int coid) { return MsgSendPulse(coid, -1, PULSE_CODE_TELEMETRY, 1); });
+}
+BENCHMARK(BM_QnxPulse)->UseRealTime();
+
+#endif  // __QNX__
+
+int main(int argc, char** argv) {
+    // libstdc++ uses non-atomic shared_ptr counts until the process starts its first thread;
+    // real programs have threads, so measure the atomic path (see ref_ptr_benchmark.cpp)
+    std::thread([] {}).join();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::AddCustomContext("indicator_kernel", kernelName());  // Stored in the JSON "context"
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+/*Reading the results
+Multi-threaded benchmarks report the time per iteration of each thread; with ThreadRange the rows for 1, 2, 4
+and 8 threads show how an operation scales. A shared atomic counter gets slower with every thread
+(its cache line moves between cores), a ShardedCounter and SensorChannel reads should stay flat.
+Counters (torn, dropped, jitter_*_ns, wcet_ns) are stored in the JSON next to the timings, so a regression in
+jitter shows up in the same comparison as a regression in speed. The executor's numbers depend heavily on
+privileges and machine load; compare them only between runs on the same, quiet machine.*/
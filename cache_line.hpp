@@ -0,0 +1,40 @@
+/*Cache-Line Padding - Avoiding False Sharing
+Two variables that live on the same cache line are "falsely shared": when one core writes its variable,
+every other core holding that line loses its copy, even though it only cares about its own variable.
+
+With one reader this is invisible. With 32 readers each updating its own counter next to the others,
+every increment becomes a cross-core cache-line transfer and throughput collapses.
+
+CachePadded<T> aligns (and therefore pads) each T to the destructive interference size,
+so every per-reader slot gets a cache line to itself.*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifdef __cpp_lib_hardware_interference_size
+// GCC warns that this value may differ between -mtune targets; we only use it inside one binary.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+inline constexpr std::size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#pragma GCC diagnostic pop
+#else
+inline constexpr std::size_t kCacheLineSize = 64;  // x86-64 and most ARMv8 cores
+#endif
+
+template <typename T>
+struct alignas(kCacheLineSize) CachePadded {
+    T value;
+
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+};
+
+// Per-reader bookkeeping kept next to the shared sensor value
+struct ReaderSlot {
+    std::atomic<std::uint64_t> reads{0};  // Only written by the owning reader
+    std::atomic<int> lastSeen{0};         // Last value the reader observed
+};
@@ -0,0 +1,60 @@
+/*CachedValue<T> - Lazy, Thread-Safe Memoization Behind a const Getter
+The classic use of mutable: a const getter computes an expensive derived value once, stores it,
+and returns the stored copy on every later call. Mutating the owner invalidates the stored copy.
+
+The mutable state lives inside CachedValue, so the owner just declares a CachedValue<T> member:
+get(compute) is const, it runs compute() only when nothing is cached, and is safe to call from
+many threads at once. After the first call the fast path is a single acquire load.
+invalidate() drops the cached value; call it from the owner's non-const (mutating) methods.
+
+Threading contract (the same one the standard library uses for const):
+concurrent const calls are safe with each other; a mutation needs exclusive access to the owner,
+and references returned by get() are valid until the next invalidate().*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class CachedValue {
+public:
+    CachedValue() = default;
+
+    // Copies and moves start empty; the new owner recomputes on first use
+    CachedValue(const CachedValue&) {}
+    CachedValue& operator=(const CachedValue&) {
+        invalidate();
+        return *this;
+    }
+
+    template <typename Compute>
+    const T& get(Compute&& compute) const {
+        if (ready_.load(std::memory_order_acquire)) {
+            return *value_;  // Fast path: already computed
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!ready_.load(std::memory_order_relaxed)) {  // Another caller may have computed it meanwhile
+            value_.emplace(std::forward<Compute>(compute)());
+            ready_.store(true, std::memory_order_release);
+        }
+        return *value_;
+    }
+
+    void invalidate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.store(false, std::memory_order_relaxed);
+        value_.reset();
+    }
+
+    bool cached() const {
+        return ready_.load(std::memory_order_acquire);
+    }
+
+private:
+    mutable std::atomic<bool> ready_{false};
+    mutable std::mutex mutex_;  // Only taken when computing or invalidating
+    mutable std::optional<T> value_;
+};
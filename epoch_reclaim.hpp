@@ -0,0 +1,202 @@
+/*EpochDomain - Epoch-Based Deferred Reclamation and RCU-Style Publication
+When the last shared_ptr to an object goes away, whoever dropped it runs delete right there.
+For a writer that replaces a large configuration object, that makes the writer pay for freeing the
+old version; and handing readers a shared_ptr makes every read an atomic increment/decrement
+on one contended count.
+
+With epoch-based reclamation readers take no reference at all:
+A reader enters a read-side section with EpochDomain::Reader::enter(), which announces the current
+global epoch in the reader's own cache-line slot, and leaves it when the guard is destroyed.
+Inside the section it may dereference any object it loaded from a published pointer.
+A writer unlinks an old object and retire()s it instead of deleting it. A background thread
+advances the epoch and frees, in batches, every retired object that no reader can still hold:
+one retired at epoch e is safe once every reader is idle or has announced an epoch later than e.
+
+RcuCell<T> packages the common case: readers call get() under a guard and see a complete version;
+update() publishes a new version and retires the old one, so neither side ever waits for the other.
+Readers must not block for long inside a section: that only delays freeing, never correctness,
+but retired memory grows until they leave. Register at most kMaxReaders reader threads per domain.*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+
+class EpochDomain {
+public:
+    static constexpr std::size_t kMaxReaders = 64;
+
+    class Guard;
+
+    // One per reader thread; owns a slot in the domain
+    class Reader {
+    public:
+        Reader(Reader&& other) noexcept : domain_(std::exchange(other.domain_, nullptr)), slot_(other.slot_) {}
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader() {
+            if (domain_) domain_->slots_[slot_]->inUse.store(false, std::memory_order_release);
+        }
+
+        Guard enter() { return Guard(domain_->slots_[slot_]->epoch, domain_->epoch_); }
+
+    private:
+        friend class EpochDomain;
+        Reader(EpochDomain* domain, std::size_t slot) : domain_(domain), slot_(slot) {}
+
+        EpochDomain* domain_;
+        std::size_t slot_;
+    };
+
+    // Read-side section: objects loaded from published pointers stay valid until it ends
+    class Guard {
+    public:
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() { slot_.store(kIdle, std::memory_order_release); }
+
+    private:
+        friend class Reader;
+        Guard(std::atomic<std::uint64_t>& slot, const std::atomic<std::uint64_t>& epoch) : slot_(slot) {
+            // seq_cst: the announcement must be visible before this reader loads any published pointer
+            slot_.store(epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+
+        std::atomic<std::uint64_t>& slot_;
+    };
+
+    explicit EpochDomain(std::chrono::milliseconds interval = std::chrono::milliseconds(1))
+        : interval_(interval), reclaimer_([this] { reclaimLoop(); }) {}
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // All readers must have left their sections; everything still retired is freed here
+    ~EpochDomain() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        wake_.notify_one();
+        reclaimer_.join();
+        for (auto& item : retired_) item.destroy(item.object);
+    }
+
+    // Throws std::runtime_error when all kMaxReaders slots are taken
+    Reader registerReader() {
+        for (std::size_t i = 0; i < kMaxReaders; ++i) {
+            bool expected = false;
+            if (slots_[i]->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                slots_[i]->epoch.store(kIdle, std::memory_order_relaxed);
+                return Reader(this, i);
+            }
+        }
+        throw std::runtime_error("EpochDomain: too many readers");
+    }
+
+    // Call after p is unreachable for new readers; it is deleted later on the reclaimer thread
+    template <typename T>
+    void retire(T* p) {
+        std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back(Retired{p, [](void* q) { delete static_cast<T*>(q); }, epoch});
+        retiredCount_++;
+    }
+
+    std::uint64_t retiredCount() const { return retiredCount_.load(std::memory_order_relaxed); }
+    std::uint64_t freedCount() const { return freedCount_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::uint64_t kIdle = ~std::uint64_t(0);
+
+    struct Slot {
+        std::atomic<std::uint64_t> epoch{kIdle};
+        std::atomic<bool> inUse{false};
+    };
+
+    struct Retired {
+        void* object;
+        void (*destroy)(void*);
+        std::uint64_t epoch;
+    };
+
+    void reclaimLoop() {
+        std::vector<Retired> batch;
+        std::vector<Retired> keep;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            wake_.wait_for(lock, interval_);
+            if (retired_.empty()) continue;
+            batch.swap(retired_);
+            lock.unlock();
+
+            // New sections see the new epoch; anything retired before it can only be held by older ones
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            std::uint64_t oldest = kIdle;
+            for (const auto& slot : slots_) {
+                std::uint64_t announced = slot->epoch.load(std::memory_order_seq_cst);
+                if (announced < oldest) oldest = announced;
+            }
+            std::uint64_t freed = 0;
+            for (auto& item : batch) {
+                if (item.epoch < oldest) {
+                    item.destroy(item.object);  // Runs here, never on the writer or a reader
+                    freed++;
+                } else {
+                    keep.push_back(item);
+                }
+            }
+            batch.clear();
+            freedCount_.fetch_add(freed, std::memory_order_relaxed);
+
+            lock.lock();
+            retired_.insert(retired_.end(), keep.begin(), keep.end());
+            keep.clear();
+        }
+    }
+
+    std::atomic<std::uint64_t> epoch_{0};
+    CachePadded<Slot> slots_[kMaxReaders];
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Retired> retired_;  // Guarded by mutex_
+    bool running_ = true;           // Guarded by mutex_
+    std::atomic<std::uint64_t> retiredCount_{0};
+    std::atomic<std::uint64_t> freedCount_{0};
+    std::thread reclaimer_;  // Last: starts after every other member is initialized
+};
+
+// A published, replaceable T: wait-free reads under an EpochDomain::Guard, deferred freeing of old versions
+template <typename T>
+class RcuCell {
+public:
+    RcuCell(EpochDomain& domain, std::unique_ptr<T> initial) : domain_(domain), current_(initial.release()) {}
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+    ~RcuCell() { delete current_.load(std::memory_order_relaxed); }
+
+    // Valid until the guard is destroyed; the guard argument documents (and enforces) that one is held
+    const T* get(const EpochDomain::Guard&) const { return current_.load(std::memory_order_acquire); }
+
+    // Publishes next; the previous version is freed once no reader can still see it
+    void update(std::unique_ptr<T> next) {
+        T* old = current_.exchange(next.release(), std::memory_order_acq_rel);
+        if (old) domain_.retire(old);
+    }
+
+private:
+    EpochDomain& domain_;
+    std::atomic<T*> current_;
+};
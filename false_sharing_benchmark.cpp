@@ -0,0 +1,110 @@
+/*False Sharing Benchmark for the Atomic Sensor Example
+Runs one sensor writer against N reader threads twice:
+packed - the shared std::atomic<int> sensorData and every reader's ReaderSlot sit side by side,
+padded - sensorData and each ReaderSlot get their own cache line (CachePadded<T>).
+
+Each reader loads sensorData and updates its own slot as fast as it can.
+The only difference between the runs is memory layout, so the gap is the cost of false sharing.
+Usage: ./false_sharing_benchmark [num_readers] [seconds_per_run]*/
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "cache_line.hpp"
+
+constexpr int kMaxReaders = 256;
+
+struct PackedLayout {
+    std::atomic<int> sensorData{25};
+    ReaderSlot slots[kMaxReaders];
+
+    std::atomic<int>& data() { return sensorData; }
+    ReaderSlot& slot(int i) { return slots[i]; }
+};
+
+struct PaddedLayout {
+    CachePadded<std::atomic<int>> sensorData{{25}};
+    CachePadded<ReaderSlot> slots[kMaxReaders];
+
+    std::atomic<int>& data() { return sensorData.value; }
+    ReaderSlot& slot(int i) { return slots[i].value; }
+};
+
+// Returns total reads per second across all readers
+template <typename Layout>
+double runReaders(int numReaders, std::chrono::milliseconds runTime) {
+    auto layout = std::make_unique<Layout>();
+    std::atomic<bool> running(true);
+
+    // Writer updates at a realistic sensor rate; the readers are what we measure
+    std::thread sensor([&] {
+        while (running.load(std::memory_order_relaxed)) {
+            layout->data().fetch_add(rand() % 5 - 2, std::memory_order_release);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < numReaders; ++i) {
+        readers.emplace_back([&, i] {
+            ReaderSlot& slot = layout->slot(i);
+            while (running.load(std::memory_order_relaxed)) {
+                int temp = layout->data().load(std::memory_order_acquire);
+                slot.lastSeen.store(temp, std::memory_order_relaxed);
+                slot.reads.store(slot.reads.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(runTime);
+    running = false;
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    sensor.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    std::uint64_t total = 0;
+    for (int i = 0; i < numReaders; ++i) {
+        total += layout->slot(i).reads.load(std::memory_order_relaxed);
+    }
+    return total / elapsed;
+}
+
+void report(const char* name, double readsPerSec, int numReaders) {
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << readsPerSec / 1e6 << " M reads/s total"
+              << std::setw(12) << readsPerSec / numReaders / 1e6 << " M reads/s per reader\n";
+}
+
+int main(int argc, char* argv[]) {
+    int numReaders = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 2;
+    if (numReaders < 1) numReaders = 1;
+    if (numReaders > kMaxReaders) numReaders = kMaxReaders;
+
+    std::cout << "Readers: " << numReaders << ", cache line: " << kCacheLineSize << " bytes, "
+              << "sizeof(ReaderSlot) packed/padded: " << sizeof(ReaderSlot) << "/" << sizeof(CachePadded<ReaderSlot>) << "\n";
+
+    auto runTime = std::chrono::milliseconds(seconds * 1000);
+    double packed = runReaders<PackedLayout>(numReaders, runTime);
+    double padded = runReaders<PaddedLayout>(numReaders, runTime);
+
+    report("packed", packed, numReaders);
+    report("padded", padded, numReaders);
+    std::cout << "Speedup from padding: " << std::setprecision(2) << padded / packed << "x\n";
+    return 0;
+}
+
+/*Reading the results
+Each reader is meant to run on its own core, so "per reader" is reads/sec per core.
+Run with num_readers = cores - 1 (one core left for the writer).
+On a single core the threads time-slice and both layouts look the same; the gap grows with core count.*/
@@ -3,6 +3,13 @@ import ta  # For technical indicators (you might already have this)
 import logging
 import matplotlib.pyplot as plt
 
+import price_columns  # Memory-mapped columnar price files
+
+try:
+    import indicator_engine  # Native one-pass RSI/MACD/Bollinger filters (build libindicator_engine.so first)
+except (ImportError, OSError):
+    indicator_engine = None
+
 # ----------------------
 # Logging Configuration (as in your script)
 # ----------------------
@@ -45,6 +52,18 @@ def bollinger_band_filter(data: pd.DataFrame, window=20, num_std_dev=2) -> pd.Se
 # 2. Data Structure for Tracking
 # ----------------------
 
+def load_price_data(path: str) -> price_columns.PriceFile:
+    """
+    Maps price history from a price_columns file (see price_columns.convert_csv / from_dataframe).
+
+    Nothing is parsed or copied: prices.close (and time, high, low, volume) are views of the mapping,
+    only the pages that are used are read, and run_parameter_sweep() takes the PriceFile directly.
+    prices.to_dataframe() gives the DataFrame that run_backtest() expects, but copies the value columns.
+    """
+    prices = price_columns.PriceFile(path)
+    logger.info(f"Mapped {prices.rows} rows from {path}")
+    return prices
+
 def run_backtest(data: pd.DataFrame, filters: dict, initial_balance=1000):
     """
     Simulates trading and tracks performance for a set of filters.
@@ -103,6 +122,37 @@ def run_backtest(data: pd.DataFrame, filters: dict, initial_balance=1000):
         logger.info(f"Backtest results for {filter_name}: {backtest_results[filter_name]}")
     return backtest_results
 
+# ----------------------
+# 3. Parameter Sweep (native engine)
+# ----------------------
+
+def run_parameter_sweep(data, grid: dict, samples=None, top=5, initial_balance=1000):
+    """
+    Backtests every combination of filter parameters in grid (or a random sample of them) on all cores.
+
+    Args:
+        data: Historical price data (Pandas DataFrame, or a PriceFile from load_price_data: its mapped
+              Close column is used without copying).
+        grid: Parameter name -> candidate values, e.g. {'rsi_period': [7, 14, 21], 'window': [20, 50]}.
+        samples: Number of random combinations to test instead of the full grid.
+        top: Number of best results to log.
+        initial_balance: Starting balance for the simulation.
+
+    Returns:
+        The sweep results (one dict per configuration and filter), best final balance first.
+    """
+    if indicator_engine is None:
+        raise RuntimeError("The parameter sweep needs the native indicator engine (libindicator_engine.so).")
+    stats = {}
+    close = data.close if isinstance(data, price_columns.PriceFile) else data['Close']
+    results = indicator_engine.sweep(close, grid, samples=samples, initial_balance=initial_balance,
+                                     stats=stats)
+    results.sort(key=lambda r: r['final_balance'], reverse=True)
+    logger.info(f"Parameter sweep: {len(results)} backtests, indicator cache {stats}")
+    for result in results[:top]:
+        logger.info(f"  {result}")
+    return results
+
 # ----------------------
 # 4. Evaluation and Comparison
 # ----------------------
@@ -149,6 +199,12 @@ if __name__ == "__main__":
         'Bollinger Band Filter': bollinger_band_filter,
         # Add more filters here
     }
+    if indicator_engine is not None:
+        filters_to_test['Combined Filter (native)'] = indicator_engine.combined_filter
 
     results = run_backtest(data, filters_to_test)
     evaluate_and_compare(results)
+
+    if indicator_engine is not None:
+        run_parameter_sweep(data, {'rsi_period': [5, 7, 14], 'fast_period': [3, 5], 'slow_period': [8, 10],
+                                   'signal_period': [3], 'window': [5, 10]})
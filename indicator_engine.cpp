@@ -0,0 +1,156 @@
+/*Indicator Engine - C Interface for Python (ctypes) and Other Callers
+Wraps the templates of indicator_engine.hpp as plain C functions over float (_f32) and double (_f64)
+columns, so a pandas/NumPy column can be handed over without a copy. indicator_engine.py loads
+the shared library and exposes the same filters as filter_framework.py.
+Outputs are caller-allocated arrays of n elements; every function returns 0 or EINVAL.
+indicator_stream_* wrap StreamingFilters for live feeds: one handle per instrument, used by one
+thread at a time; update() is O(1) and does not allocate.
+indicator_backtest_* and indicator_sweep_* run run_backtest() and the parallel parameter sweep of
+parameter_sweep.hpp natively.
+
+Build (x86-64 with AVX2; on AArch64 NEON is used without extra flags, elsewhere the scalar kernel):
+g++ -std=c++20 -O3 -mavx2 -shared -fPIC -pthread indicator_engine.cpp -o libindicator_engine.so
+or with CMake: cmake --build build --target indicator_engine (INDICATOR_ENGINE_AVX2 controls -mavx2).*/
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <system_error>
+#include <vector>
+
+#include "indicator_engine.hpp"
+#include "parameter_sweep.hpp"
+
+#define INDICATOR_EXPORT extern "C" __attribute__((visibility("default")))
+
+INDICATOR_EXPORT const char* indicator_kernel_name() { return kernelName(); }
+
+INDICATOR_EXPORT void indicator_default_params(IndicatorParams* params) { *params = IndicatorParams{}; }
+
+INDICATOR_EXPORT int indicator_rsi_f64(const double* close, std::size_t n, int period, double* rsi) {
+    return computeRsi(close, n, period, rsi);
+}
+INDICATOR_EXPORT int indicator_rsi_f32(const float* close, std::size_t n, int period, double* rsi) {
+    return computeRsi(close, n, period, rsi);
+}
+
+INDICATOR_EXPORT int indicator_macd_f64(const double* close, std::size_t n, int fast, int slow, int signalPeriod,
+                                        double* macd, double* signal) {
+    return computeMacd(close, n, fast, slow, signalPeriod, macd, signal);
+}
+INDICATOR_EXPORT int indicator_macd_f32(const float* close, std::size_t n, int fast, int slow, int signalPeriod,
+                                        double* macd, double* signal) {
+    return computeMacd(close, n, fast, slow, signalPeriod, macd, signal);
+}
+
+INDICATOR_EXPORT int indicator_bollinger_f64(const double* close, std::size_t n, int window, double numStdDev,
+                                             double* middle, double* upper, double* lower) {
+    return computeBollinger(close, n, window, numStdDev, middle, upper, lower);
+}
+INDICATOR_EXPORT int indicator_bollinger_f32(const float* close, std::size_t n, int window, double numStdDev,
+                                             double* middle, double* upper, double* lower) {
+    return computeBollinger(close, n, window, numStdDev, middle, upper, lower);
+}
+
+INDICATOR_EXPORT int indicator_filter_mask_f64(const double* close, std::size_t n, const IndicatorParams* params,
+                                               std::uint8_t* mask) {
+    return computeFilterMask(close, n, *params, mask);
+}
+INDICATOR_EXPORT int indicator_filter_mask_f32(const float* close, std::size_t n, const IndicatorParams* params,
+                                               std::uint8_t* mask) {
+    return computeFilterMask(close, n, *params, mask);
+}
+
+// Current indicator values of a stream; NaN until each is valid
+struct IndicatorSnapshot {
+    double rsi;
+    double macd;
+    double signal;
+    double middle;
+    double upper;
+    double lower;
+};
+
+INDICATOR_EXPORT int indicator_stream_create(const IndicatorParams* params, StreamingFilters** stream) {
+    if (int err = validateParams(*params)) return err;
+    try {
+        *stream = new StreamingFilters(*params);  // Allocates the Bollinger ring
+    } catch (const std::bad_alloc&) {
+        return ENOMEM;
+    }
+    return 0;
+}
+
+INDICATOR_EXPORT void indicator_stream_destroy(StreamingFilters* stream) { delete stream; }
+
+// The FilterBits of this close
+INDICATOR_EXPORT std::uint8_t indicator_stream_update(StreamingFilters* stream, double close) {
+    return stream->update(close);
+}
+
+// Feeds a history (warm-up or catch-up); mask may be null
+INDICATOR_EXPORT int indicator_stream_update_many(StreamingFilters* stream, const double* close, std::size_t n,
+                                                  std::uint8_t* mask) {
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint8_t bits = stream->update(close[i]);
+        if (mask) mask[i] = bits;
+    }
+    return 0;
+}
+
+INDICATOR_EXPORT void indicator_stream_snapshot(const StreamingFilters* stream, IndicatorSnapshot* out) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out->rsi = stream->rsi().value();
+    out->macd = stream->macd().lineReady() ? stream->macd().line() : nan;
+    out->signal = stream->macd().ready() ? stream->macd().signal() : nan;
+    out->middle = stream->bands().middle();
+    out->upper = stream->bands().upper();
+    out->lower = stream->bands().lower();
+}
+
+INDICATOR_EXPORT void indicator_backtest_f64(const double* close, const std::uint8_t* mask, std::size_t n,
+                                             std::uint8_t filters, double initialBalance, BacktestResult* out) {
+    *out = runBacktest(close, mask, n, filters, initialBalance);
+}
+INDICATOR_EXPORT void indicator_backtest_f32(const float* close, const std::uint8_t* mask, std::size_t n,
+                                             std::uint8_t filters, double initialBalance, BacktestResult* out) {
+    *out = runBacktest(close, mask, n, filters, initialBalance);
+}
+
+// results has count * setCount entries; threads 0 uses every core. Returns 0, EINVAL, ENOMEM or EAGAIN.
+template <typename T>
+static int sweep(const T* close, std::size_t n, const IndicatorParams* configs, std::size_t count,
+                 const std::uint8_t* filterSets, std::size_t setCount, double initialBalance, unsigned threads,
+                 std::size_t cacheBytes, BacktestResult* results, SweepStats* stats) {
+    try {
+        SweepOptions options;
+        options.filterSets.assign(filterSets, filterSets + setCount);
+        options.initialBalance = initialBalance;
+        options.threads = threads;
+        options.cacheBytes = cacheBytes;
+        std::vector<BacktestResult> out;
+        if (int err = runSweep(close, n, std::vector<IndicatorParams>(configs, configs + count), options, out, stats)) {
+            return err;
+        }
+        std::copy(out.begin(), out.end(), results);
+        return 0;
+    } catch (const std::bad_alloc&) {
+        return ENOMEM;
+    } catch (const std::system_error&) {  // Thread creation
+        return EAGAIN;
+    }
+}
+
+INDICATOR_EXPORT int indicator_sweep_f64(const double* close, std::size_t n, const IndicatorParams* configs,
+                                         std::size_t count, const std::uint8_t* filterSets, std::size_t setCount,
+                                         double initialBalance, unsigned threads, std::size_t cacheBytes,
+                                         BacktestResult* results, SweepStats* stats) {
+    return sweep(close, n, configs, count, filterSets, setCount, initialBalance, threads, cacheBytes, results, stats);
+}
+INDICATOR_EXPORT int indicator_sweep_f32(const float* close, std::size_t n, const IndicatorParams* configs,
+                                         std::size_t count, const std::uint8_t* filterSets, std::size_t setCount,
+                                         double initialBalance, unsigned threads, std::size_t cacheBytes,
+                                         BacktestResult* results, SweepStats* stats) {
+    return sweep(close, n, configs, count, filterSets, setCount, initialBalance, threads, cacheBytes, results, stats);
+}
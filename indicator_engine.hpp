@@ -0,0 +1,483 @@
+/*Indicator Engine - RSI, MACD and Bollinger Bands over Columnar Price Buffers, Fused into One Mask
+filter_framework.py computes each indicator with pandas from the whole Close column, once per filter,
+and every intermediate series (diffs, gains, EMAs, rolling means) is a full-length temporary.
+This engine reads a contiguous float or double column once and produces all three filter decisions
+in a single pass, block by block, so the working set stays in L1.
+
+The definitions follow the `ta` package that filter_framework.py uses, with fillna=False:
+RSI       - Wilder smoothing: ewm(alpha=1/period, adjust=False) of the up and down moves (the first
+            move is 0), RSI = 100 - 100 / (1 + up/down), or 100 when down is 0. Valid from period-1.
+MACD      - ewm(span, adjust=False) of Close for fast and slow, macd = fast - slow,
+            signal = ewm(span=signal) of macd. macd is valid from max(fast, slow)-1, signal
+            signal-1 samples later.
+Bollinger - rolling mean and population (ddof=0) standard deviation over window samples,
+            bands = mean +- numStdDev * std. Valid from window-1.
+Before an indicator is valid its values are NaN and its filter is false, as the pandas comparisons are.
+
+computeFilterMask() runs the fused pass. Each block has two stages:
+1. the recurrences (EMAs, Wilder averages, rolling moments), which are serial in time and run scalar;
+2. the filter comparisons, which are independent per sample and run 4 lanes wide with AVX2,
+   2 lanes with NEON on AArch64, or scalar otherwise (chosen at compile time, see kernelName()).
+The comparisons are rearranged to avoid divisions and square roots
+(RSI > low  <=>  100 * up > low * (up + down); |close - mean| < k * std  <=>  dev^2 < k^2 * var),
+so a sample sitting exactly on a threshold may come out differently from pandas; everything else
+agrees to rounding. Each mask byte holds one bit per filter (kRsiFilter, kMacdFilter,
+kBollingerFilter): the combined filter is mask == kAllFilters, and a single filter is one bit of the same pass.
+
+For live feeds, StreamingFilters takes one close at a time in O(1): RsiState keeps the two Wilder
+averages, MacdState the three EMAs, and BollingerState a ring buffer of the last window closes with
+their sliding Welford mean and variance. The batch kernels run on the same state classes, so a
+stream fed the same closes returns exactly the mask and values of the batch functions.
+Inputs must be finite. Every function returns 0, or EINVAL for invalid parameters.*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Standard layout: passed unchanged through the C interface (indicator_engine.cpp / indicator_engine.py)
+struct IndicatorParams {
+    std::int32_t rsiPeriod = 14;
+    std::int32_t macdFast = 12;
+    std::int32_t macdSlow = 26;
+    std::int32_t macdSignal = 9;
+    std::int32_t bbWindow = 20;
+    std::int32_t reserved = 0;
+    double rsiOversold = 30;
+    double rsiOverbought = 70;
+    double bbNumStdDev = 2;
+};
+
+enum FilterBits : std::uint8_t {
+    kRsiFilter = 1,        // rsiOversold < RSI < rsiOverbought
+    kMacdFilter = 2,       // macd > signal
+    kBollingerFilter = 4,  // lower band < Close < upper band
+    kAllFilters = 7,
+};
+
+inline int validateParams(const IndicatorParams& p) {
+    if (p.rsiPeriod < 1 || p.macdFast < 1 || p.macdSlow < 1 || p.macdSignal < 1 || p.bbWindow < 1) return EINVAL;
+    if (!(p.bbNumStdDev >= 0)) return EINVAL;
+    return 0;
+}
+
+// pandas ewm(adjust=False): the first sample seeds the average; ready after minPeriods samples
+struct ExponentialAverage {
+    double alpha;
+    std::int64_t minPeriods;
+    double value = 0;
+    std::int64_t count = 0;
+
+    ExponentialAverage(double smoothing, std::int64_t periods) : alpha(smoothing), minPeriods(periods) {}
+    static ExponentialAverage span(int periods) { return ExponentialAverage(2.0 / (periods + 1.0), periods); }
+    static ExponentialAverage wilder(int periods) { return ExponentialAverage(1.0 / periods, periods); }
+
+    void add(double x) {
+        value = count++ ? (1.0 - alpha) * value + alpha * x : x;
+    }
+    bool ready() const { return count >= minPeriods; }
+};
+
+// Mean and sum of squared deviations of the last `window` samples (sliding Welford update)
+struct RollingMoments {
+    std::int64_t window;
+    double mean = 0;
+    double m2 = 0;
+    std::int64_t count = 0;
+
+    explicit RollingMoments(std::int64_t size) : window(size) {}
+
+    // While fewer than window samples have been seen
+    void add(double x) {
+        count++;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+        trackRun(x);
+    }
+
+    // Once the window is full: oldest leaves, x enters
+    void replace(double oldest, double x) {
+        double oldMean = mean;
+        mean += (x - oldest) / window;
+        m2 += (x - oldest) * (x - mean + oldest - oldMean);
+        if (m2 < 0) m2 = 0;
+        trackRun(x);
+    }
+
+    double variance() const { return count ? m2 / count : 0; }  // ddof=0
+    bool ready() const { return count >= window; }
+
+private:
+    // A window of identical values has exactly zero variance (as in pandas); this also sheds drift
+    void trackRun(double x) {
+        run = x == last ? run + 1 : 1;
+        last = x;
+        if (run >= window) {
+            mean = x;
+            m2 = 0;
+        }
+    }
+
+    double last = 0;
+    std::int64_t run = 0;
+};
+
+// Wilder RSI state: O(1) per sample
+class RsiState {
+public:
+    explicit RsiState(int period)
+        : up_(ExponentialAverage::wilder(period)), down_(ExponentialAverage::wilder(period)) {}
+
+    void update(double close) {
+        double move = up_.count ? close - previous_ : 0.0;  // ta: the first move is 0
+        previous_ = close;
+        up_.add(move > 0 ? move : 0.0);
+        down_.add(move < 0 ? -move : 0.0);
+    }
+
+    bool ready() const { return up_.ready(); }
+    double averageGain() const { return up_.value; }
+    double averageLoss() const { return down_.value; }
+    double value() const {
+        if (!ready()) return std::numeric_limits<double>::quiet_NaN();
+        return down_.value == 0 ? 100.0 : 100.0 - 100.0 / (1.0 + up_.value / down_.value);
+    }
+
+private:
+    ExponentialAverage up_;
+    ExponentialAverage down_;
+    double previous_ = 0;
+};
+
+// MACD state: fast and slow EMAs of Close, signal EMA of the MACD line once both are valid
+class MacdState {
+public:
+    MacdState(int fast, int slow, int signal)
+        : fast_(ExponentialAverage::span(fast)), slow_(ExponentialAverage::span(slow)),
+          signal_(ExponentialAverage::span(signal)) {}
+
+    void update(double close) {
+        fast_.add(close);
+        slow_.add(close);
+        if (lineReady()) signal_.add(line());
+    }
+
+    bool lineReady() const { return fast_.ready() && slow_.ready(); }
+    bool ready() const { return signal_.ready(); }
+    double line() const { return fast_.value - slow_.value; }  // Meaningful once lineReady()
+    double signal() const { return signal_.value; }            // Meaningful once ready()
+
+private:
+    ExponentialAverage fast_;
+    ExponentialAverage slow_;
+    ExponentialAverage signal_;
+};
+
+// Bollinger state: the last window closes in a ring buffer (allocated once, here) plus their moments
+class BollingerState {
+public:
+    BollingerState(int window, double numStdDev)
+        : moments_(window), ring_(std::size_t(window)), numStdDev_(numStdDev) {}
+
+    void update(double close) {
+        if (moments_.ready()) {
+            moments_.replace(ring_[next_], close);
+        } else {
+            moments_.add(close);
+        }
+        ring_[next_] = close;
+        next_ = next_ + 1 == ring_.size() ? 0 : next_ + 1;
+    }
+
+    bool ready() const { return moments_.ready(); }
+    double mean() const { return moments_.mean; }
+    double variance() const { return moments_.variance(); }
+    double middle() const { return ready() ? moments_.mean : std::numeric_limits<double>::quiet_NaN(); }
+    double upper() const { return middle() + numStdDev_ * std::sqrt(variance()); }
+    double lower() const { return middle() - numStdDev_ * std::sqrt(variance()); }
+
+private:
+    RollingMoments moments_;
+    std::vector<double> ring_;
+    std::size_t next_ = 0;
+    double numStdDev_;
+};
+
+namespace indicator_detail {
+
+inline constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+inline constexpr std::size_t kBlock = 256;
+
+// Per-block intermediate columns of the fused pass; small enough to stay in L1
+struct BlockColumns {
+    alignas(32) double close[kBlock];
+    alignas(32) double gain[kBlock];
+    alignas(32) double loss[kBlock];
+    alignas(32) double macd[kBlock];
+    alignas(32) double signal[kBlock];
+    alignas(32) double mean[kBlock];
+    alignas(32) double variance[kBlock];
+};
+
+struct Thresholds {
+    double rsiLow;
+    double rsiHigh;
+    double bandScale2;  // numStdDev^2
+};
+
+// The scalar form of the comparisons; the SIMD kernels compute exactly the same operations per lane
+inline std::uint8_t filterBits(double close, double gain, double loss, double macd, double signal, double mean,
+                               double variance, const Thresholds& t) {
+    double up = 100.0 * gain;
+    double total = gain + loss;
+    double dev = close - mean;
+    bool rsi = up > t.rsiLow * total && up < t.rsiHigh * total;
+    bool trend = macd > signal;
+    bool band = dev * dev < t.bandScale2 * variance;
+    return static_cast<std::uint8_t>(rsi * kRsiFilter | trend * kMacdFilter | band * kBollingerFilter);
+}
+
+inline std::uint8_t maskOne(const BlockColumns& c, std::size_t j, const Thresholds& t) {
+    return filterBits(c.close[j], c.gain[j], c.loss[j], c.macd[j], c.signal[j], c.mean[j], c.variance[j], t);
+}
+
+// First index at which each filter can be true
+struct Warmup {
+    std::size_t rsi;
+    std::size_t macd;
+    std::size_t bands;
+    std::size_t all;
+
+    explicit Warmup(const IndicatorParams& p)
+        : rsi(std::size_t(p.rsiPeriod - 1)),
+          macd(std::size_t(std::max(p.macdFast, p.macdSlow) - 1 + p.macdSignal - 1)),
+          bands(std::size_t(p.bbWindow - 1)),
+          all(std::max({rsi, macd, bands})) {}
+
+    // Clears the filters that are not valid yet in block [start, start + len); only the first blocks do work
+    void apply(std::size_t start, std::size_t len, std::uint8_t* blockMask) const {
+        for (std::size_t i = start; i < start + len && i < all; ++i) {
+            std::uint8_t& bits = blockMask[i - start];
+            if (i < rsi) bits &= std::uint8_t(~kRsiFilter);
+            if (i < macd) bits &= std::uint8_t(~kMacdFilter);
+            if (i < bands) bits &= std::uint8_t(~kBollingerFilter);
+        }
+    }
+};
+
+#if defined(__AVX2__)
+inline const char* kernelName() { return "avx2"; }
+
+// 4-bit movemask -> four bytes of 0/1
+inline std::uint32_t spreadBits(int bits) {
+    static constexpr std::uint32_t table[16] = {
+        0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101,
+        0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101,
+    };
+    return table[bits];
+}
+
+inline void maskBlock(const BlockColumns& c, std::size_t len, const Thresholds& t, std::uint8_t* out) {
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256d low = _mm256_set1_pd(t.rsiLow);
+    const __m256d high = _mm256_set1_pd(t.rsiHigh);
+    const __m256d scale2 = _mm256_set1_pd(t.bandScale2);
+    std::size_t j = 0;
+    for (; j + 4 <= len; j += 4) {
+        __m256d gain = _mm256_load_pd(c.gain + j);
+        __m256d total = _mm256_add_pd(gain, _mm256_load_pd(c.loss + j));
+        __m256d up = _mm256_mul_pd(hundred, gain);
+        __m256d rsi = _mm256_and_pd(_mm256_cmp_pd(up, _mm256_mul_pd(low, total), _CMP_GT_OQ),
+                                    _mm256_cmp_pd(up, _mm256_mul_pd(high, total), _CMP_LT_OQ));
+        __m256d macd = _mm256_cmp_pd(_mm256_load_pd(c.macd + j), _mm256_load_pd(c.signal + j), _CMP_GT_OQ);
+        __m256d dev = _mm256_sub_pd(_mm256_load_pd(c.close + j), _mm256_load_pd(c.mean + j));
+        __m256d band = _mm256_cmp_pd(_mm256_mul_pd(dev, dev), _mm256_mul_pd(scale2, _mm256_load_pd(c.variance + j)),
+                                     _CMP_LT_OQ);
+        std::uint32_t bytes = spreadBits(_mm256_movemask_pd(rsi)) * kRsiFilter |
+                              spreadBits(_mm256_movemask_pd(macd)) * kMacdFilter |
+                              spreadBits(_mm256_movemask_pd(band)) * kBollingerFilter;
+        std::memcpy(out + j, &bytes, sizeof(bytes));  // Little-endian: byte k is lane k
+    }
+    for (; j < len; ++j) out[j] = maskOne(c, j, t);
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+inline const char* kernelName() { return "neon"; }
+
+inline void maskBlock(const BlockColumns& c, std::size_t len, const Thresholds& t, std::uint8_t* out) {
+    const float64x2_t hundred = vdupq_n_f64(100.0);
+    const float64x2_t low = vdupq_n_f64(t.rsiLow);
+    const float64x2_t high = vdupq_n_f64(t.rsiHigh);
+    const float64x2_t scale2 = vdupq_n_f64(t.bandScale2);
+    std::size_t j = 0;
+    for (; j + 2 <= len; j += 2) {
+        float64x2_t gain = vld1q_f64(c.gain + j);
+        float64x2_t total = vaddq_f64(gain, vld1q_f64(c.loss + j));
+        float64x2_t up = vmulq_f64(hundred, gain);
+        uint64x2_t rsi = vandq_u64(vcgtq_f64(up, vmulq_f64(low, total)), vcltq_f64(up, vmulq_f64(high, total)));
+        uint64x2_t macd = vcgtq_f64(vld1q_f64(c.macd + j), vld1q_f64(c.signal + j));
+        float64x2_t dev = vsubq_f64(vld1q_f64(c.close + j), vld1q_f64(c.mean + j));
+        uint64x2_t band = vcltq_f64(vmulq_f64(dev, dev), vmulq_f64(scale2, vld1q_f64(c.variance + j)));
+        // All-ones lanes -> one bit per filter
+        uint64x2_t bits = vorrq_u64(vorrq_u64(vandq_u64(rsi, vdupq_n_u64(kRsiFilter)),
+                                              vandq_u64(macd, vdupq_n_u64(kMacdFilter))),
+                                    vandq_u64(band, vdupq_n_u64(kBollingerFilter)));
+        out[j] = static_cast<std::uint8_t>(vgetq_lane_u64(bits, 0));
+        out[j + 1] = static_cast<std::uint8_t>(vgetq_lane_u64(bits, 1));
+    }
+    for (; j < len; ++j) out[j] = maskOne(c, j, t);
+}
+
+#else
+inline const char* kernelName() { return "scalar"; }
+
+inline void maskBlock(const BlockColumns& c, std::size_t len, const Thresholds& t, std::uint8_t* out) {
+    for (std::size_t j = 0; j < len; ++j) out[j] = maskOne(c, j, t);
+}
+#endif
+
+}  // namespace indicator_detail
+
+// Which comparison kernel this build uses: "avx2", "neon" or "scalar"
+inline const char* kernelName() { return indicator_detail::kernelName(); }
+
+// All three filters fed one close at a time, O(1) per sample and no allocation after construction.
+// update() returns the same FilterBits byte that computeFilterMask() produces for that sample.
+// The parameters must pass validateParams().
+class StreamingFilters {
+public:
+    explicit StreamingFilters(const IndicatorParams& p)
+        : rsi_(p.rsiPeriod), macd_(p.macdFast, p.macdSlow, p.macdSignal), bands_(p.bbWindow, p.bbNumStdDev),
+          thresholds_{p.rsiOversold, p.rsiOverbought, p.bbNumStdDev * p.bbNumStdDev} {}
+
+    std::uint8_t update(double close) {
+        rsi_.update(close);
+        macd_.update(close);
+        bands_.update(close);
+        std::uint8_t bits = indicator_detail::filterBits(close, rsi_.averageGain(), rsi_.averageLoss(), macd_.line(),
+                                                         macd_.signal(), bands_.mean(), bands_.variance(),
+                                                         thresholds_);
+        if (!rsi_.ready()) bits &= std::uint8_t(~kRsiFilter);
+        if (!macd_.ready()) bits &= std::uint8_t(~kMacdFilter);
+        if (!bands_.ready()) bits &= std::uint8_t(~kBollingerFilter);
+        last_ = bits;
+        return bits;
+    }
+
+    std::uint8_t lastMask() const { return last_; }
+    const RsiState& rsi() const { return rsi_; }
+    const MacdState& macd() const { return macd_; }
+    const BollingerState& bands() const { return bands_; }
+
+private:
+    RsiState rsi_;
+    MacdState macd_;
+    BollingerState bands_;
+    indicator_detail::Thresholds thresholds_;
+    std::uint8_t last_ = 0;
+};
+
+template <typename T>
+int computeRsi(const T* close, std::size_t n, int period, double* rsi) {
+    if (period < 1) return EINVAL;
+    RsiState state(period);
+    for (std::size_t i = 0; i < n; ++i) {
+        state.update(double(close[i]));
+        rsi[i] = state.value();
+    }
+    return 0;
+}
+
+template <typename T>
+int computeMacd(const T* close, std::size_t n, int fast, int slow, int signalPeriod, double* macd, double* signal) {
+    if (fast < 1 || slow < 1 || signalPeriod < 1) return EINVAL;
+    MacdState state(fast, slow, signalPeriod);
+    for (std::size_t i = 0; i < n; ++i) {
+        state.update(double(close[i]));
+        macd[i] = state.lineReady() ? state.line() : indicator_detail::kNaN;
+        signal[i] = state.ready() ? state.signal() : indicator_detail::kNaN;
+    }
+    return 0;
+}
+
+// Same arithmetic as BollingerState, with the input column itself as the window
+template <typename T>
+int computeBollinger(const T* close, std::size_t n, int window, double numStdDev, double* middle, double* upper,
+                     double* lower) {
+    if (window < 1 || !(numStdDev >= 0)) return EINVAL;
+    RollingMoments moments(window);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (moments.ready()) {
+            moments.replace(double(close[i - window]), double(close[i]));
+        } else {
+            moments.add(double(close[i]));
+        }
+        if (!moments.ready()) {
+            middle[i] = upper[i] = lower[i] = indicator_detail::kNaN;
+            continue;
+        }
+        double width = numStdDev * std::sqrt(moments.variance());
+        middle[i] = moments.mean;
+        upper[i] = moments.mean + width;
+        lower[i] = moments.mean - width;
+    }
+    return 0;
+}
+
+// One pass over close: mask[i] gets one FilterBits bit per filter that passes at sample i
+template <typename T>
+int computeFilterMask(const T* close, std::size_t n, const IndicatorParams& p, std::uint8_t* mask) {
+    using namespace indicator_detail;
+    if (int err = validateParams(p)) return err;
+
+    RsiState rsi(p.rsiPeriod);
+    MacdState macd(p.macdFast, p.macdSlow, p.macdSignal);
+    RollingMoments moments(p.bbWindow);
+    const Thresholds thresholds{p.rsiOversold, p.rsiOverbought, p.bbNumStdDev * p.bbNumStdDev};
+
+    const Warmup warmup(p);
+
+    BlockColumns cols;
+    for (std::size_t start = 0; start < n; start += kBlock) {
+        std::size_t len = std::min(kBlock, n - start);
+
+        // Stage 1: serial recurrences
+        for (std::size_t j = 0; j < len; ++j) {
+            std::size_t i = start + j;
+            double x = double(close[i]);
+            rsi.update(x);
+            macd.update(x);
+            if (moments.ready()) {
+                moments.replace(double(close[i - p.bbWindow]), x);
+            } else {
+                moments.add(x);
+            }
+            cols.close[j] = x;
+            cols.gain[j] = rsi.averageGain();
+            cols.loss[j] = rsi.averageLoss();
+            cols.macd[j] = macd.line();
+            cols.signal[j] = macd.signal();
+            cols.mean[j] = moments.mean;
+            cols.variance[j] = moments.variance();
+        }
+
+        // Stage 2: independent comparisons, SIMD
+        maskBlock(cols, len, thresholds, mask + start);
+
+        warmup.apply(start, len, mask + start);
+    }
+    return 0;
+}
@@ -0,0 +1,394 @@
+"""ctypes bindings for the native indicator engine (indicator_engine.cpp).
+
+Drop-in replacements for the filters in filter_framework.py that compute all three indicators in
+one native pass over the Close column instead of one pandas pipeline per filter:
+
+    import indicator_engine as ie
+    masks = ie.filter_masks(data)              # {'rsi', 'macd', 'bollinger', 'combined'} -> Series
+    signals = ie.combined_filter(data)         # RSI and MACD and Bollinger, one pass
+    results = run_backtest(data, {'RSI Filter': ie.rsi_filter, 'Combined': ie.combined_filter})
+
+Parameter sweeps backtest every combination of a grid (or a random sample of it) on all cores,
+sharing the Close column and the indicator intermediates between configurations:
+
+    results = ie.sweep(data['Close'], {'rsi_period': [7, 14, 21], 'fast_period': [8, 12], 'window': [20, 50]})
+    best = max(results, key=lambda r: r['final_balance'])
+
+For live feeds, StreamingFilters keeps the indicator state natively and takes one close per call:
+
+    stream = ie.StreamingFilters()
+    stream.warm_up(history['Close'])           # Same masks as filter_mask(history['Close'])
+    if stream.update(tick_close) == ie.FILTER_ALL: ...
+
+Build the library first (see indicator_engine.cpp); it is looked up in INDICATOR_ENGINE_LIB,
+then next to this file, then on the normal library path.
+The low-level functions take any float32/float64 sequence (NumPy arrays without a copy) and return
+NumPy arrays when NumPy is available, array.array / bytearray otherwise.
+"""
+
+import ctypes
+import os
+from array import array
+
+try:
+    import numpy as _np
+except ImportError:  # The engine itself does not need NumPy
+    _np = None
+
+FILTER_RSI = 1
+FILTER_MACD = 2
+FILTER_BOLLINGER = 4
+FILTER_ALL = 7
+
+
+class IndicatorSnapshot(ctypes.Structure):
+    """Mirror of struct IndicatorSnapshot in indicator_engine.cpp."""
+    _fields_ = [(name, ctypes.c_double) for name in ('rsi', 'macd', 'signal', 'middle', 'upper', 'lower')]
+
+
+class BacktestResult(ctypes.Structure):
+    """Mirror of struct BacktestResult in parameter_sweep.hpp."""
+    _fields_ = [('final_balance', ctypes.c_double), ('num_trades', ctypes.c_int64),
+                ('win_rate', ctypes.c_double), ('total_profit', ctypes.c_double)]
+
+
+class SweepStats(ctypes.Structure):
+    """Mirror of struct SweepStats in parameter_sweep.hpp."""
+    _fields_ = [('cache_hits', ctypes.c_uint64), ('cache_misses', ctypes.c_uint64), ('steals', ctypes.c_uint64)]
+
+
+class IndicatorParams(ctypes.Structure):
+    """Mirror of struct IndicatorParams in indicator_engine.hpp."""
+    _fields_ = [
+        ('rsi_period', ctypes.c_int32),
+        ('macd_fast', ctypes.c_int32),
+        ('macd_slow', ctypes.c_int32),
+        ('macd_signal', ctypes.c_int32),
+        ('bb_window', ctypes.c_int32),
+        ('reserved', ctypes.c_int32),
+        ('rsi_oversold', ctypes.c_double),
+        ('rsi_overbought', ctypes.c_double),
+        ('bb_num_std_dev', ctypes.c_double),
+    ]
+
+
+def _load_library():
+    names = [os.environ.get('INDICATOR_ENGINE_LIB'),
+             os.path.join(os.path.dirname(os.path.abspath(__file__)), 'libindicator_engine.so'),
+             'libindicator_engine.so']
+    errors = []
+    for name in filter(None, names):
+        try:
+            return ctypes.CDLL(name)
+        except OSError as exc:
+            errors.append(str(exc))
+    raise OSError('libindicator_engine.so not found; build it from indicator_engine.cpp '
+                  '(' + '; '.join(errors) + ')')
+
+
+_lib = _load_library()
+_ptr = ctypes.c_void_p
+_size = ctypes.c_size_t
+_int = ctypes.c_int
+_double = ctypes.c_double
+
+_lib.indicator_kernel_name.restype = ctypes.c_char_p
+_lib.indicator_kernel_name.argtypes = []
+_lib.indicator_default_params.restype = None
+_lib.indicator_default_params.argtypes = [ctypes.POINTER(IndicatorParams)]
+for _suffix in ('f64', 'f32'):
+    for _name, _args in (('rsi', [_ptr, _size, _int, _ptr]),
+                         ('macd', [_ptr, _size, _int, _int, _int, _ptr, _ptr]),
+                         ('bollinger', [_ptr, _size, _int, _double, _ptr, _ptr, _ptr]),
+                         ('filter_mask', [_ptr, _size, ctypes.POINTER(IndicatorParams), _ptr])):
+        _fn = getattr(_lib, 'indicator_%s_%s' % (_name, _suffix))
+        _fn.restype = _int
+        _fn.argtypes = _args
+
+_lib.indicator_stream_create.restype = _int
+_lib.indicator_stream_create.argtypes = [ctypes.POINTER(IndicatorParams), ctypes.POINTER(_ptr)]
+_lib.indicator_stream_destroy.restype = None
+_lib.indicator_stream_destroy.argtypes = [_ptr]
+_lib.indicator_stream_update.restype = ctypes.c_uint8
+_lib.indicator_stream_update.argtypes = [_ptr, _double]
+_lib.indicator_stream_update_many.restype = _int
+_lib.indicator_stream_update_many.argtypes = [_ptr, _ptr, _size, _ptr]
+_lib.indicator_stream_snapshot.restype = None
+_lib.indicator_stream_snapshot.argtypes = [_ptr, ctypes.POINTER(IndicatorSnapshot)]
+for _suffix in ('f64', 'f32'):
+    _fn = getattr(_lib, 'indicator_backtest_' + _suffix)
+    _fn.restype = None
+    _fn.argtypes = [_ptr, _ptr, _size, ctypes.c_uint8, _double, ctypes.POINTER(BacktestResult)]
+    _fn = getattr(_lib, 'indicator_sweep_' + _suffix)
+    _fn.restype = _int
+    _fn.argtypes = [_ptr, _size, ctypes.POINTER(IndicatorParams), _size, _ptr, _size, _double,
+                    ctypes.c_uint, _size, ctypes.POINTER(BacktestResult), ctypes.POINTER(SweepStats)]
+
+
+def kernel_name():
+    """The comparison kernel the library was built with: 'avx2', 'neon' or 'scalar'."""
+    return _lib.indicator_kernel_name().decode()
+
+
+def make_params(rsi_period=14, rsi_oversold=30, rsi_overbought=70, fast_period=12, slow_period=26,
+                signal_period=9, window=20, num_std_dev=2):
+    """IndicatorParams with the defaults of filter_framework.py."""
+    params = IndicatorParams()
+    _lib.indicator_default_params(ctypes.byref(params))
+    params.rsi_period, params.rsi_oversold, params.rsi_overbought = rsi_period, rsi_oversold, rsi_overbought
+    params.macd_fast, params.macd_slow, params.macd_signal = fast_period, slow_period, signal_period
+    params.bb_window, params.bb_num_std_dev = window, num_std_dev
+    return params
+
+
+def params_dict(params):
+    """The make_params() keyword arguments that give params."""
+    return {'rsi_period': params.rsi_period, 'rsi_oversold': params.rsi_oversold,
+            'rsi_overbought': params.rsi_overbought, 'fast_period': params.macd_fast,
+            'slow_period': params.macd_slow, 'signal_period': params.macd_signal,
+            'window': params.bb_window, 'num_std_dev': params.bb_num_std_dev}
+
+
+def _column(values):
+    """(pointer, length, suffix, keepalive) for a contiguous float32/float64 column."""
+    if hasattr(values, 'to_numpy'):  # pandas Series
+        values = values.to_numpy()
+    if isinstance(values, memoryview) and values.format in ('d', 'f') and values.c_contiguous \
+            and not values.readonly:  # e.g. a price_columns.PriceFile column without NumPy
+        address = ctypes.addressof(ctypes.c_char.from_buffer(values)) if len(values) else None
+        return _ptr(address), len(values), 'f32' if values.format == 'f' else 'f64', values
+    if _np is not None:
+        column = _np.ascontiguousarray(values)
+        if column.dtype not in (_np.float32, _np.float64):
+            column = column.astype(_np.float64)
+        suffix = 'f32' if column.dtype == _np.float32 else 'f64'
+        return _ptr(column.ctypes.data), len(column), suffix, column
+    column = values if isinstance(values, array) and values.typecode in 'fd' else array('d', values)
+    return _ptr(column.buffer_info()[0] if len(column) else None), len(column), \
+        'f32' if column.typecode == 'f' else 'f64', column
+
+
+def _doubles(n):
+    if _np is not None:
+        out = _np.empty(n, dtype=_np.float64)
+        return out, _ptr(out.ctypes.data)
+    out = array('d', bytes(8 * n))
+    return out, _ptr(out.buffer_info()[0] if n else None)
+
+
+def _bytes(n):
+    if _np is not None:
+        out = _np.empty(n, dtype=_np.uint8)
+        return out, _ptr(out.ctypes.data)
+    out = bytearray(n)
+    return out, _ptr(ctypes.addressof((ctypes.c_uint8 * n).from_buffer(out)) if n else None)
+
+
+def _check(err, name):
+    if err:
+        raise ValueError('%s: invalid parameters (%s)' % (name, os.strerror(err)))
+
+
+def rsi(close, period=14):
+    """Wilder RSI, NaN for the first period-1 samples (same as ta with fillna=False)."""
+    ptr, n, suffix, keep = _column(close)
+    out, out_ptr = _doubles(n)
+    _check(getattr(_lib, 'indicator_rsi_' + suffix)(ptr, n, period, out_ptr), 'rsi')
+    return out
+
+
+def macd(close, fast_period=12, slow_period=26, signal_period=9):
+    """(macd, signal) arrays, NaN until each is valid."""
+    ptr, n, suffix, keep = _column(close)
+    line, line_ptr = _doubles(n)
+    signal, signal_ptr = _doubles(n)
+    _check(getattr(_lib, 'indicator_macd_' + suffix)(ptr, n, fast_period, slow_period, signal_period,
+                                                      line_ptr, signal_ptr), 'macd')
+    return line, signal
+
+
+def bollinger(close, window=20, num_std_dev=2):
+    """(middle, upper, lower) bands with the population standard deviation (ddof=0)."""
+    ptr, n, suffix, keep = _column(close)
+    middle, middle_ptr = _doubles(n)
+    upper, upper_ptr = _doubles(n)
+    lower, lower_ptr = _doubles(n)
+    _check(getattr(_lib, 'indicator_bollinger_' + suffix)(ptr, n, window, num_std_dev,
+                                                           middle_ptr, upper_ptr, lower_ptr), 'bollinger')
+    return middle, upper, lower
+
+
+def filter_mask(close, params=None):
+    """One fused pass: a byte per sample with FILTER_RSI | FILTER_MACD | FILTER_BOLLINGER bits."""
+    params = params if params is not None else make_params()
+    ptr, n, suffix, keep = _column(close)
+    out, out_ptr = _bytes(n)
+    _check(getattr(_lib, 'indicator_filter_mask_' + suffix)(ptr, n, ctypes.byref(params), out_ptr), 'filter_mask')
+    return out
+
+
+_FILTER_SETS = {'rsi': FILTER_RSI, 'macd': FILTER_MACD, 'bollinger': FILTER_BOLLINGER, 'combined': FILTER_ALL}
+_PARAM_NAMES = ('rsi_period', 'rsi_oversold', 'rsi_overbought', 'fast_period', 'slow_period', 'signal_period',
+                'window', 'num_std_dev')
+
+
+def _result_dict(result):
+    return {name: getattr(result, name) for name, _ in BacktestResult._fields_}
+
+
+def backtest(close, mask, filters=FILTER_ALL, initial_balance=1000):
+    """run_backtest() of filter_framework.py on one filter set of a filter_mask()."""
+    ptr, n, suffix, keep = _column(close)
+    if len(mask) != n:
+        raise ValueError('backtest: mask and close differ in length')
+    if _np is not None:
+        mask = _np.ascontiguousarray(mask, dtype=_np.uint8)
+        mask_ptr = _ptr(mask.ctypes.data)
+    else:
+        mask = bytearray(mask)
+        mask_ptr = _ptr(ctypes.addressof((ctypes.c_uint8 * n).from_buffer(mask)) if n else None)
+    result = BacktestResult()
+    getattr(_lib, 'indicator_backtest_' + suffix)(ptr, mask_ptr, n, filters, initial_balance, ctypes.byref(result))
+    return _result_dict(result)
+
+
+def grid_configs(grid, samples=None, seed=0):
+    """Parameter dicts for every combination of grid (make_params names -> candidate lists),
+    or for `samples` distinct combinations drawn at random."""
+    import itertools
+    import random
+    unknown = set(grid) - set(_PARAM_NAMES)
+    if unknown:
+        raise ValueError('grid_configs: unknown parameters %s' % sorted(unknown))
+    names = [name for name in _PARAM_NAMES if name in grid]
+    combos = list(itertools.product(*(grid[name] for name in names)))
+    if samples is not None and samples < len(combos):
+        combos = random.Random(seed).sample(combos, samples)
+    return [dict(zip(names, combo)) for combo in combos]
+
+
+def sweep(close, grid=None, samples=None, seed=0, filters=('rsi', 'macd', 'bollinger', 'combined'),
+          initial_balance=1000, threads=0, cache_bytes=1 << 30, stats=None):
+    """Backtests every configuration of grid (see grid_configs) with every filter set, in parallel.
+
+    Returns one dict per (configuration, filter set): the parameters, 'filter', and the
+    run_backtest() metrics final_balance, num_trades, win_rate and total_profit.
+    Pass a dict as stats to receive the cache hit/miss and work-steal counts.
+    """
+    configs = grid_configs(grid or {}, samples, seed)
+    ptr, n, suffix, keep = _column(close)
+    params = (IndicatorParams * len(configs))(*(make_params(**config) for config in configs))
+    sets = (ctypes.c_uint8 * len(filters))(*(_FILTER_SETS[name] for name in filters))
+    results = (BacktestResult * (len(configs) * len(filters)))()
+    counters = SweepStats()
+    _check(getattr(_lib, 'indicator_sweep_' + suffix)(ptr, n, params, len(configs), _ptr(ctypes.addressof(sets)),
+                                                       len(filters), initial_balance, threads, cache_bytes,
+                                                       results, ctypes.byref(counters)), 'sweep')
+    if stats is not None:
+        stats.update({name: getattr(counters, name) for name, _ in SweepStats._fields_})
+    out = []
+    for c, config in enumerate(configs):
+        for s, name in enumerate(filters):
+            row = params_dict(params[c])
+            row['filter'] = name
+            row.update(_result_dict(results[c * len(filters) + s]))
+            out.append(row)
+    return out
+
+
+class StreamingFilters:
+    """RSI, MACD and Bollinger filters updated one close at a time, O(1) per tick.
+
+    The state lives in the native library (StreamingFilters in indicator_engine.hpp), and it runs
+    the same arithmetic as the batch functions. Feeding the closes of a series one by one therefore
+    returns exactly the bytes of filter_mask() for that series.
+    """
+
+    def __init__(self, params=None, **kwargs):
+        self._handle = None
+        self.params = params if params is not None else make_params(**kwargs)
+        handle = _ptr()
+        _check(_lib.indicator_stream_create(ctypes.byref(self.params), ctypes.byref(handle)), 'StreamingFilters')
+        self._handle = handle
+        self.mask = 0
+
+    def update(self, close):
+        """Feeds one close; returns its FILTER_* bits."""
+        self.mask = _lib.indicator_stream_update(self._handle, close)
+        return self.mask
+
+    def warm_up(self, closes):
+        """Feeds a history in one native call; returns its mask, like filter_mask()."""
+        if hasattr(closes, 'to_numpy'):
+            closes = closes.to_numpy()
+        if _np is not None:
+            closes = _np.ascontiguousarray(closes, dtype=_np.float64)
+            ptr, n = _ptr(closes.ctypes.data), len(closes)
+        else:
+            closes = array('d', closes)
+            ptr, n = _ptr(closes.buffer_info()[0] if len(closes) else None), len(closes)
+        out, out_ptr = _bytes(n)
+        _check(_lib.indicator_stream_update_many(self._handle, ptr, n, out_ptr), 'warm_up')
+        if n:
+            self.mask = out[-1]
+        return out
+
+    def passes(self, bits=FILTER_ALL):
+        """True when every filter in bits passed on the last close."""
+        return (self.mask & bits) == bits
+
+    def snapshot(self):
+        """Current indicator values (NaN until valid)."""
+        values = IndicatorSnapshot()
+        _lib.indicator_stream_snapshot(self._handle, ctypes.byref(values))
+        return {name: getattr(values, name) for name, _ in IndicatorSnapshot._fields_}
+
+    def close(self):
+        if self._handle:
+            _lib.indicator_stream_destroy(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        self.close()
+
+
+# ----------------------
+# pandas drop-ins for filter_framework.py
+# ----------------------
+
+def _series(data, mask, bits):
+    import pandas as pd
+    if _np is not None:
+        values = (mask & bits) == bits
+    else:
+        values = [(m & bits) == bits for m in mask]
+    return pd.Series(values, index=data.index)
+
+
+def filter_masks(data, **params):
+    """Every filter from one pass: {'rsi', 'macd', 'bollinger', 'combined'} -> boolean Series."""
+    mask = filter_mask(data['Close'], make_params(**params))
+    return {'rsi': _series(data, mask, FILTER_RSI),
+            'macd': _series(data, mask, FILTER_MACD),
+            'bollinger': _series(data, mask, FILTER_BOLLINGER),
+            'combined': _series(data, mask, FILTER_ALL)}
+
+
+def rsi_filter(data, rsi_period=14, rsi_oversold=30, rsi_overbought=70):
+    params = make_params(rsi_period=rsi_period, rsi_oversold=rsi_oversold, rsi_overbought=rsi_overbought)
+    return _series(data, filter_mask(data['Close'], params), FILTER_RSI)
+
+
+def macd_filter(data, fast_period=12, slow_period=26, signal_period=9):
+    params = make_params(fast_period=fast_period, slow_period=slow_period, signal_period=signal_period)
+    return _series(data, filter_mask(data['Close'], params), FILTER_MACD)
+
+
+def bollinger_band_filter(data, window=20, num_std_dev=2):
+    params = make_params(window=window, num_std_dev=num_std_dev)
+    return _series(data, filter_mask(data['Close'], params), FILTER_BOLLINGER)
+
+
+def combined_filter(data, **params):
+    """RSI and MACD and Bollinger Band filters together, computed in a single pass."""
+    return _series(data, filter_mask(data['Close'], make_params(**params)), FILTER_ALL)
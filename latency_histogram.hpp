@@ -0,0 +1,71 @@
+/*LatencyHistogram - Fixed-Size Nanosecond Histogram for Latency and Jitter Measurements
+Storing every sample to compute percentiles afterwards allocates on the measured path and grows
+without bound. A histogram with a fixed set of buckets records a sample in a few instructions,
+never allocates, and still answers p50/p99 within a known error; min, max and mean are exact.
+Not thread-safe: record from one thread, or protect it.*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear buckets: 8 per power of two, so every bucket is within 12.5% of its value
+// (values below 8 ns are exact). Max, min and sum are exact.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kSubBuckets = 8;
+    static constexpr std::size_t kBuckets = (64 - 3 + 1) * kSubBuckets;
+
+    void record(std::int64_t ns) {
+        std::uint64_t value = ns < 0 ? 0 : static_cast<std::uint64_t>(ns);
+        buckets_[bucketOf(value)]++;
+        if (count_ == 0 || value < min_) min_ = value;
+        if (value > max_) max_ = value;
+        sum_ += value;
+        count_++;
+    }
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t min() const { return min_; }
+    std::uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // Upper bound of the bucket containing the given percentile, capped at the exact maximum
+    std::uint64_t percentile(double p) const {
+        if (count_ == 0) return 0;
+        std::uint64_t rank = static_cast<std::uint64_t>(p / 100.0 * (count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                std::uint64_t upper = bucketUpper(i);
+                return upper < max_ ? upper : max_;
+            }
+        }
+        return max_;
+    }
+
+    std::uint64_t bucket(std::size_t i) const { return buckets_[i]; }
+
+    static std::size_t bucketOf(std::uint64_t value) {
+        if (value < kSubBuckets) return static_cast<std::size_t>(value);
+        std::size_t msb = 63 - static_cast<std::size_t>(__builtin_clzll(value));
+        std::size_t sub = static_cast<std::size_t>(value >> (msb - 3)) & (kSubBuckets - 1);
+        return (msb - 2) * kSubBuckets + sub;
+    }
+
+    static std::uint64_t bucketUpper(std::size_t i) {
+        if (i < kSubBuckets) return i;
+        std::size_t msb = i / kSubBuckets + 2;
+        std::uint64_t sub = i % kSubBuckets;
+        if (msb == 63 && sub == kSubBuckets - 1) return ~0ull;
+        return ((kSubBuckets + sub + 1) << (msb - 3)) - 1;
+    }
+
+private:
+    std::uint64_t buckets_[kBuckets] = {};
+    std::uint64_t count_ = 0;
+    std::uint64_t min_ = 0;
+    std::uint64_t max_ = 0;
+    std::uint64_t sum_ = 0;
+};
@@ -0,0 +1,143 @@
+/*local_ref_ptr / atomic_ref_ptr - Intrusive Reference Counting without a Control Block
+std::shared_ptr keeps its counts in a separate control block (make_shared merely co-allocates it),
+and every copy and destruction is an atomic read-modify-write, a locked instruction on x86, even
+when the object never leaves the thread that created it.
+
+Here the count lives inside the object: derive from LocalRefCounted (plain uint32_t count) or
+AtomicRefCounted (std::atomic count) and hold the object through local_ref_ptr<T> or atomic_ref_ptr<T>.
+Both pointers have the same interface, so switching an object between single-threaded and shared
+use is a change of base class and pointer alias.
+local_ref_ptr  - copies are a non-atomic increment; the object must stay on one thread.
+atomic_ref_ptr - copies are relaxed atomic increments, the final release is acq_rel; thread-safe
+                 like shared_ptr for distinct pointer objects.
+There is no weak pointer and no custom deleter: the object is destroyed with delete when the
+count reaches zero. Use std::shared_ptr where those are needed.
+Because the last pointer deletes through its own T*, a basic_ref_ptr<Base> can only be made from a
+Derived pointer if Base has a virtual destructor (std::shared_ptr remembers the deleter instead).*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+class LocalRefCounted {
+public:
+    void addRef() const noexcept { ++refs_; }
+    bool releaseRef() const noexcept { return --refs_ == 0; }  // true: last reference gone
+    std::uint32_t refCount() const noexcept { return refs_; }
+
+protected:
+    LocalRefCounted() = default;
+    LocalRefCounted(const LocalRefCounted&) noexcept {}  // A copy is a new object with its own owners
+    LocalRefCounted& operator=(const LocalRefCounted&) noexcept { return *this; }
+    ~LocalRefCounted() = default;
+
+private:
+    mutable std::uint32_t refs_ = 0;
+};
+
+class AtomicRefCounted {
+public:
+    void addRef() const noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+    // acq_rel: the deleting thread must see every write made through the other references
+    bool releaseRef() const noexcept { return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+    std::uint32_t refCount() const noexcept { return refs_.load(std::memory_order_relaxed); }
+
+protected:
+    AtomicRefCounted() = default;
+    AtomicRefCounted(const AtomicRefCounted&) noexcept {}
+    AtomicRefCounted& operator=(const AtomicRefCounted&) noexcept { return *this; }
+    ~AtomicRefCounted() = default;
+
+private:
+    mutable std::atomic<std::uint32_t> refs_{0};
+};
+
+template <typename T, typename Counted>
+class basic_ref_ptr {
+    static_assert(std::is_base_of_v<Counted, T>, "T must derive from the matching *RefCounted base");
+
+    // A U owned through T* is deleted as a T: only allowed if that is the same type or ~T is virtual
+    template <typename U>
+    static constexpr bool kConvertible =
+        std::is_convertible_v<U*, T*> &&
+        (std::is_same_v<std::remove_cv_t<U>, std::remove_cv_t<T>> || std::has_virtual_destructor_v<T>);
+
+public:
+    using element_type = T;
+
+    constexpr basic_ref_ptr() noexcept = default;
+    constexpr basic_ref_ptr(std::nullptr_t) noexcept {}
+
+    // Takes shared ownership of p (freshly allocated or already owned by other ref pointers)
+    explicit basic_ref_ptr(T* p) noexcept : ptr_(p) {
+        if (ptr_) ptr_->addRef();
+    }
+
+    // basic_ref_ptr<Base>(new Derived) with a non-virtual ~Base would delete a Derived as a Base
+    template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T> && std::is_convertible_v<U*, T*> &&
+                                                      !kConvertible<U>>>
+    explicit basic_ref_ptr(U* p) = delete;
+
+    basic_ref_ptr(const basic_ref_ptr& other) noexcept : basic_ref_ptr(other.ptr_) {}
+    basic_ref_ptr(basic_ref_ptr&& other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+    template <typename U, typename = std::enable_if_t<kConvertible<U>>>
+    basic_ref_ptr(const basic_ref_ptr<U, Counted>& other) noexcept : ptr_(other.get()) {
+        if (ptr_) ptr_->addRef();
+    }
+
+    template <typename U, typename = std::enable_if_t<kConvertible<U>>>
+    basic_ref_ptr(basic_ref_ptr<U, Counted>&& other) noexcept : ptr_(other.release()) {}
+
+    ~basic_ref_ptr() { drop(ptr_); }
+
+    basic_ref_ptr& operator=(basic_ref_ptr other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void reset() noexcept { drop(std::exchange(ptr_, nullptr)); }
+    void reset(T* p) noexcept { basic_ref_ptr(p).swap(*this); }
+    void swap(basic_ref_ptr& other) noexcept { std::swap(ptr_, other.ptr_); }
+
+    // Gives up ownership without decrementing; the caller owns one reference
+    T* release() noexcept { return std::exchange(ptr_, nullptr); }
+
+    T* get() const noexcept { return ptr_; }
+    T& operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+    std::uint32_t use_count() const noexcept { return ptr_ ? ptr_->refCount() : 0; }
+
+    template <typename U>
+    bool operator==(const basic_ref_ptr<U, Counted>& other) const noexcept {
+        return ptr_ == other.get();
+    }
+    bool operator==(std::nullptr_t) const noexcept { return ptr_ == nullptr; }
+
+private:
+    static void drop(T* p) noexcept {
+        if (p && p->releaseRef()) delete p;
+    }
+
+    T* ptr_ = nullptr;
+};
+
+template <typename T>
+using local_ref_ptr = basic_ref_ptr<T, LocalRefCounted>;
+
+template <typename T>
+using atomic_ref_ptr = basic_ref_ptr<T, AtomicRefCounted>;
+
+template <typename T, typename... Args>
+local_ref_ptr<T> make_local_ref(Args&&... args) {
+    return local_ref_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+template <typename T, typename... Args>
+atomic_ref_ptr<T> make_atomic_ref(Args&&... args) {
+    return atomic_ref_ptr<T>(new T(std::forward<Args>(args)...));
+}
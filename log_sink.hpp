@@ -0,0 +1,270 @@
+/*LogSink - Batched, Non-Blocking Logging for Hot-Path Threads
+std::cout << ... takes the stream lock on every call and usually ends in one write() syscall per line.
+With many reader threads logging every sample, the threads queue up behind each other on the console.
+
+LogSink gives every logging thread its own single-producer/single-consumer ring buffer:
+The hot-path thread formats the line on its stack and copies it into its ring (no lock, no syscall).
+A background flusher thread drains all rings into one large buffer and writes it with a single write().
+If a ring is full the line is dropped and counted instead of blocking the caller.
+
+Lines from one thread stay in order; lines from different threads are interleaved per flush,
+not globally ordered. Create one LogSink (e.g. in main) before starting the threads that use it.
+
+Each thread caches its rings per sink (a few entries, keyed by sink id), so a thread switching between
+sinks still finds its ring without a lock or an allocation. A ring is allocated only the first time a
+thread logs to a sink; when the thread exits its rings are handed back and reused by later threads.*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include "cache_line.hpp"
+
+class LogSink {
+public:
+    static constexpr std::size_t kMaxLine = 512;  // Longer lines are truncated
+
+    explicit LogSink(int fd = STDOUT_FILENO,
+                     std::size_t ringBytes = 64 * 1024,
+                     std::chrono::milliseconds flushInterval = std::chrono::milliseconds(10))
+        : id_(nextId()), fd_(fd), ringBytes_(roundUpPow2(ringBytes)), flushInterval_(flushInterval),
+          flusher_([this] { flushLoop(); }) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        liveSinks().push_back(this);
+    }
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    ~LogSink() {
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());  // Exiting threads no longer touch this sink
+            auto& sinks = liveSinks();
+            sinks.erase(std::find(sinks.begin(), sinks.end(), this));
+        }
+        running_.store(false, std::memory_order_relaxed);
+        flusher_.join();
+        drainAll();  // Anything logged after the flusher's last pass
+    }
+
+    // Formats the arguments into one line and queues it. Never blocks; returns false if dropped.
+    template <typename... Args>
+    bool log(const Args&... args) {
+        char line[kMaxLine];
+        std::size_t len = 0;
+        (append(line, len, args), ...);
+        if (!ringForThisThread().push(line, len)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    // Lines discarded because a ring was full
+    std::uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Batches written so far (one write() per batch, not per line)
+    std::uint64_t writes() const {
+        return writes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Single-producer/single-consumer byte ring, capacity is a power of two
+    class Ring {
+    public:
+        explicit Ring(std::size_t capacity) : data_(new char[capacity]), mask_(capacity - 1) {}
+
+        bool push(const char* bytes, std::size_t len) {
+            std::size_t head = head_->load(std::memory_order_relaxed);
+            std::size_t tail = tail_->load(std::memory_order_acquire);
+            if (len > mask_ + 1 - (head - tail)) {
+                return false;
+            }
+            std::size_t offset = head & mask_;
+            std::size_t first = std::min(len, mask_ + 1 - offset);
+            std::memcpy(&data_[offset], bytes, first);
+            std::memcpy(&data_[0], bytes + first, len - first);
+            head_->store(head + len, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side: appends everything queued to out
+        void drainInto(std::vector<char>& out) {
+            std::size_t tail = tail_->load(std::memory_order_relaxed);
+            std::size_t head = head_->load(std::memory_order_acquire);
+            std::size_t len = head - tail;
+            std::size_t offset = tail & mask_;
+            std::size_t first = std::min(len, mask_ + 1 - offset);
+            out.insert(out.end(), &data_[offset], &data_[offset] + first);
+            out.insert(out.end(), &data_[0], &data_[0] + (len - first));
+            tail_->store(head, std::memory_order_release);
+        }
+
+        std::thread::id owner;  // Producer thread, guarded by ringsMutex_; default id: free for reuse
+
+    private:
+        std::unique_ptr<char[]> data_;
+        std::size_t mask_;
+        CachePadded<std::atomic<std::size_t>> head_{{0}};  // Written by the producer
+        CachePadded<std::atomic<std::size_t>> tail_{{0}};  // Written by the flusher
+    };
+
+    // A thread's ring cache; its destructor hands the thread's rings back when the thread exits
+    struct ThreadRings {
+        static constexpr std::size_t kEntries = 8;
+        std::uint64_t ids[kEntries] = {};
+        Ring* rings[kEntries] = {};
+        std::size_t next = 0;  // Round-robin replacement once a thread uses more than kEntries sinks
+        ~ThreadRings() { releaseThreadRings(); }
+    };
+
+    // Ids are never reused, so a cache entry of a destroyed sink never matches again
+    static std::uint64_t nextId() {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    static std::size_t roundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    static void append(char* line, std::size_t& len, std::string_view text) {
+        std::size_t n = std::min(text.size(), kMaxLine - len);
+        std::memcpy(line + len, text.data(), n);
+        len += n;
+    }
+
+    static void append(char* line, std::size_t& len, const char* text) {
+        append(line, len, std::string_view(text));
+    }
+
+    static void append(char* line, std::size_t& len, char c) {
+        append(line, len, std::string_view(&c, 1));
+    }
+
+    static void append(char* line, std::size_t& len, bool value) {
+        append(line, len, value ? std::string_view("true") : std::string_view("false"));
+    }
+
+    // std::to_chars(bool) is deleted, so bool takes the overload above
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>>
+    static void append(char* line, std::size_t& len, T value) {
+        auto result = std::to_chars(line + len, line + kMaxLine, value);
+        if (result.ec == std::errc()) {
+            len = result.ptr - line;
+        }
+    }
+
+    // Hot path: a scan of this thread's cache, no lock
+    Ring& ringForThisThread() {
+        thread_local ThreadRings cache;
+        for (std::size_t i = 0; i < ThreadRings::kEntries; ++i) {
+            if (cache.ids[i] == id_) return *cache.rings[i];
+        }
+        std::size_t slot = cache.next++ % ThreadRings::kEntries;
+        cache.rings[slot] = &claimRing();
+        cache.ids[slot] = id_;
+        return *cache.rings[slot];
+    }
+
+    // Cache miss: the ring this thread already owns (its entry was replaced), a ring an exited thread
+    // handed back, or, only the first time this thread logs here, a new one
+    Ring& claimRing() {
+        const std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        for (auto& ring : rings_) {
+            if (ring->owner == self) return *ring;
+        }
+        for (auto& ring : rings_) {
+            if (ring->owner == std::thread::id()) {
+                ring->owner = self;  // Lines the previous owner queued are still drained in order
+                return *ring;
+            }
+        }
+        rings_.push_back(std::make_unique<Ring>(ringBytes_));
+        rings_.back()->owner = self;
+        return *rings_.back();
+    }
+
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<LogSink*>& liveSinks() {  // Guarded by registryMutex()
+        static std::vector<LogSink*> sinks;
+        return sinks;
+    }
+
+    // Thread exit: frees this thread's rings in every sink that still exists
+    static void releaseThreadRings() {
+        const std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> registry(registryMutex());
+        for (LogSink* sink : liveSinks()) {
+            std::lock_guard<std::mutex> lock(sink->ringsMutex_);
+            for (auto& ring : sink->rings_) {
+                if (ring->owner == self) ring->owner = std::thread::id();
+            }
+        }
+    }
+
+    void flushLoop() {
+        while (running_.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(flushInterval_);
+            drainAll();
+        }
+    }
+
+    void drainAll() {
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            for (auto& ring : rings_) {
+                ring->drainInto(batch_);
+            }
+        }
+        std::size_t written = 0;
+        while (written < batch_.size()) {
+            ssize_t n = ::write(fd_, batch_.data() + written, batch_.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;  // Nowhere to report a logging failure; drop the batch
+            }
+            written += static_cast<std::size_t>(n);
+        }
+        if (!batch_.empty()) {
+            writes_.fetch_add(1, std::memory_order_relaxed);
+        }
+        batch_.clear();
+    }
+
+    const std::uint64_t id_;
+    const int fd_;
+    const std::size_t ringBytes_;
+    const std::chrono::milliseconds flushInterval_;
+    std::mutex ringsMutex_;                    // Guards rings_ and Ring::owner (registration and draining only)
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::vector<char> batch_;                  // Only touched by the flusher (and the destructor)
+    std::atomic<bool> running_{true};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> writes_{0};
+    std::thread flusher_;                      // Declared last so it starts after the members above
+};
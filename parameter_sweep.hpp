@@ -0,0 +1,477 @@
+/*Parameter Sweep - Backtesting Many Filter Configurations in Parallel with Shared Intermediates
+filter_framework.py backtests one parameter set at a time. A sweep over a grid of RSI periods,
+MACD spans and Bollinger windows repeats most of that work: every configuration with macdFast = 12
+recomputes the same 12-span EMA of the whole Close column.
+
+runSweep() evaluates a list of IndicatorParams (expandGrid() / sampleGrid() build one from a
+SweepGrid) on all cores:
+- The Close column is shared read-only by every worker: pass a pointer into a memory-mapped file
+  or a NumPy/pandas buffer, and nothing is copied.
+- IndicatorCache computes each intermediate column once and shares it: the EMA of Close per span,
+  the Wilder gain/loss averages per RSI period and the rolling mean/variance per Bollinger window.
+  It holds up to cacheBytes of columns and drops the least recently used ones beyond that. Only the
+  MACD signal EMA, which depends on the (fast, slow, signal) triple, is computed per configuration.
+- WorkStealingScheduler gives each worker a contiguous range of configurations (sorted so that
+  neighbours share cached columns); an idle worker steals the back half of the busiest range.
+Each configuration is backtested for every filter set in SweepOptions::filterSets (by default
+RSI, MACD, Bollinger and all three combined) with the rules of run_backtest() in filter_framework.py:
+buy one unit when the signal turns on and the balance covers the price, sell when it turns off.
+The masks are the same as computeFilterMask() for that configuration, bit for bit.*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+#include "indicator_engine.hpp"
+
+// Standard layout: returned unchanged through the C interface
+struct BacktestResult {
+    double finalBalance;
+    std::int64_t numTrades;
+    double winRate;  // Percent of closed trades with profit > 0
+    double totalProfit;
+};
+
+// run_backtest() of filter_framework.py as a state machine fed one sample at a time
+class BacktestState {
+public:
+    explicit BacktestState(double initialBalance) : balance_(initialBalance) {}
+
+    void step(bool signal, double close) {
+        if (signal && !inPosition_) {
+            if (balance_ > close) {
+                inPosition_ = true;
+                buyPrice_ = close;
+                balance_ -= close;
+            }
+        } else if (!signal && inPosition_) {
+            double profit = close - buyPrice_;
+            balance_ += close;
+            inPosition_ = false;
+            trades_++;
+            if (profit > 0) wins_++;
+            totalProfit_ += profit;
+        }
+    }
+
+    BacktestResult result() const {
+        double winRate = trades_ ? double(wins_) / double(trades_) * 100 : 0;
+        return BacktestResult{balance_, trades_, winRate, totalProfit_};
+    }
+
+private:
+    double balance_;
+    double buyPrice_ = 0;
+    double totalProfit_ = 0;
+    std::int64_t trades_ = 0;
+    std::int64_t wins_ = 0;
+    bool inPosition_ = false;
+};
+
+// Backtests one filter set of a precomputed mask (see computeFilterMask())
+template <typename T>
+BacktestResult runBacktest(const T* close, const std::uint8_t* mask, std::size_t n, std::uint8_t filters,
+                           double initialBalance = 1000) {
+    BacktestState state(initialBalance);
+    for (std::size_t i = 0; i < n; ++i) state.step((mask[i] & filters) == filters, double(close[i]));
+    return state.result();
+}
+
+// Intermediate columns shared between configurations; thread-safe, each column is computed once
+template <typename T>
+class IndicatorCache {
+public:
+    // Two columns of one intermediate: (EMA, unused), (gain, loss) or (mean, variance)
+    struct Columns {
+        std::vector<double> first;
+        std::vector<double> second;
+    };
+    using Entry = std::shared_ptr<const Columns>;
+
+    IndicatorCache(const T* close, std::size_t n, std::size_t budgetBytes)
+        : close_(close), n_(n), budgetBytes_(budgetBytes) {}
+
+    Entry ema(int span) {
+        return get(Key{'e', span}, [&] {
+            auto cols = std::make_shared<Columns>();
+            cols->first.resize(n_);
+            ExponentialAverage average = ExponentialAverage::span(span);
+            for (std::size_t i = 0; i < n_; ++i) {
+                average.add(double(close_[i]));
+                cols->first[i] = average.value;
+            }
+            return cols;
+        });
+    }
+
+    Entry rsi(int period) {
+        return get(Key{'r', period}, [&] {
+            auto cols = std::make_shared<Columns>();
+            cols->first.resize(n_);
+            cols->second.resize(n_);
+            RsiState state(period);
+            for (std::size_t i = 0; i < n_; ++i) {
+                state.update(double(close_[i]));
+                cols->first[i] = state.averageGain();
+                cols->second[i] = state.averageLoss();
+            }
+            return cols;
+        });
+    }
+
+    Entry bands(int window) {
+        return get(Key{'b', window}, [&] {
+            auto cols = std::make_shared<Columns>();
+            cols->first.resize(n_);
+            cols->second.resize(n_);
+            RollingMoments moments(window);
+            for (std::size_t i = 0; i < n_; ++i) {
+                if (moments.ready()) {
+                    moments.replace(double(close_[i - window]), double(close_[i]));
+                } else {
+                    moments.add(double(close_[i]));
+                }
+                cols->first[i] = moments.mean;
+                cols->second[i] = moments.variance();
+            }
+            return cols;
+        });
+    }
+
+    std::uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    std::uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    using Key = std::pair<char, int>;
+
+    struct Slot {
+        std::shared_future<Entry> column;
+        std::size_t bytes = 0;
+        std::uint64_t lastUse = 0;
+    };
+
+    template <typename Compute>
+    Entry get(const Key& key, Compute&& compute) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = slots_.find(key);
+        if (it != slots_.end()) {
+            it->second.lastUse = ++useClock_;
+            std::shared_future<Entry> column = it->second.column;
+            lock.unlock();
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return column.get();  // Waits if another worker is still computing it
+        }
+        std::promise<Entry> promise;
+        Slot& slot = slots_[key];
+        slot.column = promise.get_future().share();
+        slot.lastUse = ++useClock_;
+        lock.unlock();
+        misses_.fetch_add(1, std::memory_order_relaxed);
+
+        Entry column;
+        try {
+            column = compute();  // Outside the lock: other keys proceed in parallel
+        } catch (...) {
+            promise.set_exception(std::current_exception());  // Waiting workers see the same error
+            lock.lock();
+            slots_.erase(key);  // Still computing, so never evicted: a later get() tries again
+            throw;
+        }
+        promise.set_value(column);
+
+        lock.lock();
+        auto self = slots_.find(key);
+        self->second.bytes = (column->first.size() + column->second.size()) * sizeof(double);
+        usedBytes_ += self->second.bytes;
+        evict(key);
+        return column;
+    }
+
+    // Drops least recently used, finished columns until the budget holds; users keep theirs alive
+    void evict(const Key& keep) {
+        while (usedBytes_ > budgetBytes_) {
+            auto victim = slots_.end();
+            for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+                if (it->first == keep || it->second.bytes == 0) continue;  // Current or still computing
+                if (victim == slots_.end() || it->second.lastUse < victim->second.lastUse) victim = it;
+            }
+            if (victim == slots_.end()) return;
+            usedBytes_ -= victim->second.bytes;
+            slots_.erase(victim);
+        }
+    }
+
+    const T* close_;
+    std::size_t n_;
+    std::size_t budgetBytes_;
+    std::mutex mutex_;
+    std::map<Key, Slot> slots_;  // Guarded by mutex_
+    std::size_t usedBytes_ = 0;  // Guarded by mutex_
+    std::uint64_t useClock_ = 0;  // Guarded by mutex_
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+};
+
+// Runs fn(task, worker) for task in [0, count) on `threads` workers with work stealing.
+// If fn or thread creation throws, the remaining tasks are abandoned, every started thread is joined
+// and the first exception is rethrown.
+class WorkStealingScheduler {
+public:
+    template <typename Fn>
+    static std::uint64_t run(std::size_t count, unsigned threads, Fn&& fn) {
+        threads = std::max(1u, std::min<unsigned>(threads, unsigned(std::max<std::size_t>(count, 1))));
+        std::unique_ptr<CachePadded<Range>[]> ranges(new CachePadded<Range>[threads]);
+        for (unsigned w = 0; w < threads; ++w) {
+            ranges[w]->begin = count * w / threads;  // Contiguous: neighbouring tasks share cache entries
+            ranges[w]->end = count * (w + 1) / threads;
+        }
+        std::atomic<std::uint64_t> steals{0};
+        std::atomic<bool> failed{false};
+        std::vector<std::exception_ptr> errors(threads);  // errors[w] is only written by worker w
+
+        auto worker = [&](unsigned self) {
+            try {
+                std::size_t task;
+                while (!failed.load(std::memory_order_relaxed)) {
+                    if (ranges[self]->pop(task)) {
+                        fn(task, self);
+                    } else if (!steal(ranges.get(), threads, self)) {
+                        return;  // Every range is empty
+                    } else {
+                        steals.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            } catch (...) {
+                errors[self] = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        try {
+            for (unsigned w = 1; w < threads; ++w) pool.emplace_back(worker, w);
+        } catch (...) {  // std::system_error: stop the threads already running, then report it
+            errors[0] = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+        if (!errors[0]) worker(0);
+        for (auto& t : pool) t.join();
+        for (auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+        return steals.load();
+    }
+
+private:
+    struct Range {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+
+        bool pop(std::size_t& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (begin == end) return false;
+            task = begin++;
+            return true;
+        }
+        std::size_t remaining() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return end - begin;
+        }
+    };
+
+    // Moves the back half of the fullest other range to self; false when there is nothing left
+    static bool steal(CachePadded<Range>* ranges, unsigned threads, unsigned self) {
+        for (;;) {
+            unsigned victim = self;
+            std::size_t most = 0;
+            for (unsigned w = 0; w < threads; ++w) {
+                if (w == self) continue;
+                std::size_t r = ranges[w]->remaining();
+                if (r > most) {
+                    most = r;
+                    victim = w;
+                }
+            }
+            if (victim == self) return false;
+
+            std::size_t from, to;
+            {
+                std::lock_guard<std::mutex> lock(ranges[victim]->mutex);
+                std::size_t left = ranges[victim]->end - ranges[victim]->begin;
+                if (left == 0) continue;  // Emptied meanwhile: look again
+                to = ranges[victim]->end;
+                from = to - (left + 1) / 2;
+                ranges[victim]->end = from;
+            }
+            std::lock_guard<std::mutex> lock(ranges[self]->mutex);
+            ranges[self]->begin = from;
+            ranges[self]->end = to;
+            return true;
+        }
+    }
+};
+
+// Candidate values per parameter; expandGrid() forms every combination
+struct SweepGrid {
+    std::vector<int> rsiPeriods{14};
+    std::vector<double> rsiOversold{30};
+    std::vector<double> rsiOverbought{70};
+    std::vector<int> macdFast{12};
+    std::vector<int> macdSlow{26};
+    std::vector<int> macdSignal{9};
+    std::vector<int> bbWindows{20};
+    std::vector<double> bbNumStdDev{2};
+
+    std::size_t size() const {
+        return rsiPeriods.size() * rsiOversold.size() * rsiOverbought.size() * macdFast.size() * macdSlow.size() *
+               macdSignal.size() * bbWindows.size() * bbNumStdDev.size();
+    }
+
+    // Combination number `index` (mixed radix, last parameter fastest)
+    IndicatorParams at(std::size_t index) const {
+        IndicatorParams p;
+        auto digit = [&index](const auto& values) {
+            auto value = values[index % values.size()];
+            index /= values.size();
+            return value;
+        };
+        p.bbNumStdDev = digit(bbNumStdDev);
+        p.bbWindow = digit(bbWindows);
+        p.macdSignal = digit(macdSignal);
+        p.macdSlow = digit(macdSlow);
+        p.macdFast = digit(macdFast);
+        p.rsiOverbought = digit(rsiOverbought);
+        p.rsiOversold = digit(rsiOversold);
+        p.rsiPeriod = digit(rsiPeriods);
+        return p;
+    }
+};
+
+inline std::vector<IndicatorParams> expandGrid(const SweepGrid& grid) {
+    std::vector<IndicatorParams> configs;
+    configs.reserve(grid.size());
+    for (std::size_t i = 0; i < grid.size(); ++i) configs.push_back(grid.at(i));
+    return configs;
+}
+
+// `count` distinct combinations drawn uniformly (all of them if the grid is smaller)
+inline std::vector<IndicatorParams> sampleGrid(const SweepGrid& grid, std::size_t count, std::uint64_t seed) {
+    std::size_t total = grid.size();
+    if (count >= total) return expandGrid(grid);
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, total - 1);
+    std::set<std::size_t> chosen;
+    while (chosen.size() < count) chosen.insert(pick(rng));
+    std::vector<IndicatorParams> configs;
+    configs.reserve(count);
+    for (std::size_t index : chosen) configs.push_back(grid.at(index));
+    return configs;
+}
+
+struct SweepOptions {
+    std::vector<std::uint8_t> filterSets{kRsiFilter, kMacdFilter, kBollingerFilter, kAllFilters};
+    double initialBalance = 1000;
+    unsigned threads = 0;  // 0: std::thread::hardware_concurrency()
+    std::size_t cacheBytes = std::size_t(1) << 30;
+};
+
+struct SweepStats {
+    std::uint64_t cacheHits;
+    std::uint64_t cacheMisses;
+    std::uint64_t steals;
+};
+
+namespace sweep_detail {
+
+// One configuration, all filter sets: the fused pass of computeFilterMask() on cached columns
+template <typename T>
+void evaluate(const T* close, std::size_t n, const IndicatorParams& p, IndicatorCache<T>& cache,
+              const SweepOptions& options, BacktestResult* results) {
+    using namespace indicator_detail;
+    auto fast = cache.ema(p.macdFast);
+    auto slow = cache.ema(p.macdSlow);
+    auto rsi = cache.rsi(p.rsiPeriod);
+    auto bands = cache.bands(p.bbWindow);
+    ExponentialAverage signal = ExponentialAverage::span(p.macdSignal);
+    const std::size_t macdFirst = std::size_t(std::max(p.macdFast, p.macdSlow) - 1);
+    const Thresholds thresholds{p.rsiOversold, p.rsiOverbought, p.bbNumStdDev * p.bbNumStdDev};
+    const Warmup warmup(p);
+
+    std::vector<BacktestState> states(options.filterSets.size(), BacktestState(options.initialBalance));
+    BlockColumns cols;
+    std::uint8_t mask[kBlock];
+    for (std::size_t start = 0; start < n; start += kBlock) {
+        std::size_t len = std::min(kBlock, n - start);
+        for (std::size_t j = 0; j < len; ++j) {
+            std::size_t i = start + j;
+            double macd = fast->first[i] - slow->first[i];
+            if (i >= macdFirst) signal.add(macd);
+            cols.close[j] = double(close[i]);
+            cols.gain[j] = rsi->first[i];
+            cols.loss[j] = rsi->second[i];
+            cols.macd[j] = macd;
+            cols.signal[j] = signal.value;
+            cols.mean[j] = bands->first[i];
+            cols.variance[j] = bands->second[i];
+        }
+        maskBlock(cols, len, thresholds, mask);
+        warmup.apply(start, len, mask);
+        for (std::size_t s = 0; s < states.size(); ++s) {
+            std::uint8_t filters = options.filterSets[s];
+            for (std::size_t j = 0; j < len; ++j) states[s].step((mask[j] & filters) == filters, cols.close[j]);
+        }
+    }
+    for (std::size_t s = 0; s < states.size(); ++s) results[s] = states[s].result();
+}
+
+}  // namespace sweep_detail
+
+// results[c * filterSets.size() + s] is configuration c backtested with filter set s.
+// Returns 0, or EINVAL if a configuration is invalid (nothing is run then). Throws std::bad_alloc, or
+// std::system_error if a worker thread cannot be started, after every started worker has finished.
+template <typename T>
+int runSweep(const T* close, std::size_t n, const std::vector<IndicatorParams>& configs, const SweepOptions& options,
+             std::vector<BacktestResult>& results, SweepStats* stats = nullptr) {
+    for (const auto& p : configs) {
+        if (int err = validateParams(p)) return err;
+    }
+    const std::size_t sets = options.filterSets.size();
+    results.assign(configs.size() * sets, BacktestResult{});
+
+    // Run order groups configurations that share cached columns
+    std::vector<std::size_t> order(configs.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        const IndicatorParams& x = configs[a];
+        const IndicatorParams& y = configs[b];
+        return std::tie(x.macdFast, x.macdSlow, x.rsiPeriod, x.bbWindow) <
+               std::tie(y.macdFast, y.macdSlow, y.rsiPeriod, y.bbWindow);
+    });
+
+    IndicatorCache<T> cache(close, n, options.cacheBytes);
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t steals = WorkStealingScheduler::run(order.size(), threads, [&](std::size_t task, unsigned) {
+        std::size_t c = order[task];
+        sweep_detail::evaluate(close, n, configs[c], cache, options, results.data() + c * sets);
+    });
+    if (stats) *stats = SweepStats{cache.hits(), cache.misses(), steals};
+    return 0;
+}
@@ -0,0 +1,269 @@
+/*Pool and Arena Allocators - Heap-Free Object Lifetimes for the Real-Time Path
+make_shared/make_unique call the global allocator: its latency depends on the heap's history,
+it may take a lock or a page fault, and long-running loops fragment it. A control loop that creates
+and frees objects every cycle inherits all of that.
+
+FixedBlockPool reserves blockCount blocks of one size at startup (one allocation, pre-faulted) and
+keeps the free ones in an intrusive free list: allocate and deallocate are a pointer pop/push, O(1)
+and bounded, with no heap call after construction. Exhaustion returns nullptr instead of growing.
+MonotonicArena hands out memory from one buffer by bumping a pointer; individual frees are no-ops
+and reset() releases everything at once (per-cycle scratch data, startup-time configuration).
+
+Adapters:
+PoolAllocator<T> / ArenaAllocator<T> - standard allocators, so std::allocate_shared<T>(alloc, ...)
+    places the object and its control block in the pool or arena. The pool's block size must hold
+    the control block too: size it with sharedBlockSize<T>().
+makePooled<T>(pool, ...) - std::unique_ptr<T, PoolDeleter<T>> whose deleter runs ~T and returns
+    the block to its pool.
+The pool and arena are not thread-safe: give each real-time thread its own, or lock around them.*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+class FixedBlockPool {
+public:
+    // alignment must be a power of two (std::invalid_argument otherwise); std::length_error if
+    // blockSize * blockCount does not fit in a size_t
+    FixedBlockPool(std::size_t blockSize, std::size_t blockCount,
+                   std::size_t alignment = alignof(std::max_align_t))
+        : blockSize_(roundUp(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize,
+                             checkedAlignment(alignment))),
+          blockCount_(blockCount), alignment_(checkedAlignment(alignment)),
+          storage_(static_cast<unsigned char*>(
+              ::operator new(storageBytes(blockSize_, blockCount), std::align_val_t(alignment_)))) {
+        // Threading the free list writes every block, so all pages are faulted in here, not on the hot path
+        for (std::size_t i = blockCount; i-- > 0;) {
+            push(storage_ + i * blockSize_);
+        }
+    }
+
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    ~FixedBlockPool() { ::operator delete(storage_, std::align_val_t(alignment_)); }
+
+    // nullptr when every block is in use
+    void* allocate() noexcept {
+        FreeBlock* block = free_;
+        if (block == nullptr) return nullptr;
+        free_ = block->next;
+        --available_;
+        return block;
+    }
+
+    void deallocate(void* p) noexcept {
+        if (p) push(p);
+    }
+
+    bool owns(const void* p) const {
+        const unsigned char* c = static_cast<const unsigned char*>(p);
+        return c >= storage_ && c < storage_ + blockSize_ * blockCount_;
+    }
+
+    std::size_t blockSize() const { return blockSize_; }
+    std::size_t alignment() const { return alignment_; }
+    std::size_t capacity() const { return blockCount_; }
+    std::size_t available() const { return available_; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t roundUp(std::size_t n, std::size_t to) {
+        if (n > SIZE_MAX - (to - 1)) throw std::length_error("FixedBlockPool: blockSize overflows");
+        return (n + to - 1) / to * to;
+    }
+
+    // Blocks also hold the free-list pointer, so they are at least pointer-aligned
+    static std::size_t checkedAlignment(std::size_t alignment) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument("FixedBlockPool: alignment must be a power of two");
+        }
+        return alignment < alignof(FreeBlock) ? alignof(FreeBlock) : alignment;
+    }
+
+    static std::size_t storageBytes(std::size_t blockSize, std::size_t blockCount) {
+        if (blockCount != 0 && blockSize > SIZE_MAX / blockCount) {
+            throw std::length_error("FixedBlockPool: blockSize * blockCount overflows");
+        }
+        return blockSize * blockCount;
+    }
+
+    void push(void* p) {
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = free_;
+        free_ = block;
+        ++available_;
+    }
+
+    std::size_t blockSize_;
+    std::size_t blockCount_;
+    std::size_t alignment_;
+    unsigned char* storage_;
+    FreeBlock* free_ = nullptr;
+    std::size_t available_ = 0;
+};
+
+class MonotonicArena {
+public:
+    explicit MonotonicArena(std::size_t bytes)
+        : capacity_(bytes), buffer_(static_cast<unsigned char*>(::operator new(bytes))) {
+        for (std::size_t i = 0; i < bytes; i += 4096) {
+            buffer_[i] = 0;  // Pre-fault
+        }
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() { ::operator delete(buffer_); }
+
+    // nullptr when the arena is full
+    void* allocate(std::size_t bytes, std::size_t alignment) noexcept {
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer_);
+        std::uintptr_t aligned = (base + used_ + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        std::size_t end = static_cast<std::size_t>(aligned - base) + bytes;
+        if (end > capacity_) return nullptr;
+        used_ = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Everything allocated so far is released; nothing is destroyed
+    void reset() noexcept { used_ = 0; }
+
+    std::size_t used() const { return used_; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    std::size_t capacity_;
+    std::size_t used_ = 0;
+    unsigned char* buffer_;
+};
+
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(FixedBlockPool& pool) noexcept : pool_(&pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    // Throws std::bad_alloc if the request does not fit one block or the pool is exhausted
+    T* allocate(std::size_t n) {
+        if (n * sizeof(T) > pool_->blockSize() || alignof(T) > pool_->alignment()) throw std::bad_alloc();
+        void* p = pool_->allocate();
+        if (p == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept { pool_->deallocate(p); }
+
+    FixedBlockPool* pool() const noexcept { return pool_; }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return pool_ == other.pool();
+    }
+
+private:
+    FixedBlockPool* pool_;
+};
+
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept : arena_(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(std::size_t n) {
+        void* p = arena_->allocate(n * sizeof(T), alignof(T));
+        if (p == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}  // Released by MonotonicArena::reset()
+
+    MonotonicArena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+
+private:
+    MonotonicArena* arena_;
+};
+
+template <typename T>
+struct PoolDeleter {
+    FixedBlockPool* pool;
+
+    void operator()(T* p) const noexcept {
+        p->~T();
+        pool->deallocate(p);
+    }
+};
+
+template <typename T>
+using PooledPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+// Constructs a T in a pool block; returns an empty pointer if the pool is exhausted, or if its blocks are
+// too small or not aligned enough for T
+template <typename T, typename... Args>
+PooledPtr<T> makePooled(FixedBlockPool& pool, Args&&... args) {
+    if (sizeof(T) > pool.blockSize() || alignof(T) > pool.alignment()) {
+        return PooledPtr<T>(nullptr, PoolDeleter<T>{&pool});
+    }
+    void* p = pool.allocate();
+    if (p == nullptr) return PooledPtr<T>(nullptr, PoolDeleter<T>{&pool});
+    try {
+        return PooledPtr<T>(new (p) T(std::forward<Args>(args)...), PoolDeleter<T>{&pool});
+    } catch (...) {
+        pool.deallocate(p);
+        throw;
+    }
+}
+
+namespace pool_detail {
+
+// Records the size of the single allocation allocate_shared makes (object + control block)
+template <typename T>
+struct SizeProbe {
+    using value_type = T;
+    std::size_t* bytes;
+
+    explicit SizeProbe(std::size_t* b) : bytes(b) {}
+    template <typename U>
+    SizeProbe(const SizeProbe<U>& other) : bytes(other.bytes) {}
+
+    T* allocate(std::size_t n) {
+        *bytes = n * sizeof(T);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p); }
+
+    template <typename U>
+    bool operator==(const SizeProbe<U>&) const { return true; }
+};
+
+}  // namespace pool_detail
+
+// Block size a FixedBlockPool needs for std::allocate_shared<T>. Constructs one T from args on the heap:
+// call it at startup, not on the real-time path.
+template <typename T, typename... Args>
+std::size_t sharedBlockSize(Args&&... args) {
+    std::size_t bytes = 0;
+    std::allocate_shared<T>(pool_detail::SizeProbe<T>(&bytes), std::forward<Args>(args)...);
+    return bytes;
+}
@@ -0,0 +1,255 @@
+/*Price Columns File - Memory-Mapped Columnar Price History
+Loading years of history into a DataFrame parses and copies every value before the first filter runs,
+and the whole data set has to fit in RAM. This format stores each column as one contiguous array,
+so a reader maps the file and hands out pointers: nothing is parsed or copied, pages are read on
+first touch, and every process mapping the same file shares one copy in the page cache.
+
+Layout (little-endian):
+    PriceFileHeader (128 bytes)            magic, version, row count, value type, column offsets
+    time    int64[rows]                    nanoseconds since the epoch, non-decreasing (the time index)
+    close   float64[rows] or float32[rows]
+    high    ...
+    low     ...
+    volume  ...
+Every column starts on a 64-byte boundary, so it is aligned for AVX loads and starts a cache line.
+Missing High/Low/Volume data is stored as NaN.
+
+PriceFile maps a file read-only (error() reports why it could not); column<T>() returns the
+column as a pointer, rowsBetween() binary-searches the time index for a time range, so a backtest
+over one year of a ten-year file touches only that year's pages. writePriceFile() writes the format
+from in-memory columns; price_columns.py converts CSV files and DataFrames and reads the format from Python.*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum PriceColumn : std::uint32_t { kTimeColumn, kCloseColumn, kHighColumn, kLowColumn, kVolumeColumn, kPriceColumns };
+
+struct PriceFileHeader {
+    static constexpr char kMagic[8] = {'P', 'X', 'C', 'O', 'L', 'S', '\r', '\n'};
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::uint32_t kByteOrder = 0x01020304;
+    static constexpr std::uint64_t kAlignment = 64;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;     // Reads back as kByteOrder only on a machine of the writer's endianness
+    std::uint64_t rows;
+    std::uint32_t valueBytes;    // 8: float64 price/volume columns, 4: float32
+    std::uint32_t headerBytes;   // sizeof(PriceFileHeader)
+    std::int64_t firstTime;      // time[0] and time[rows - 1], 0 when empty
+    std::int64_t lastTime;
+    std::uint64_t offsets[kPriceColumns];  // Byte offset of each column from the start of the file
+    std::uint8_t reserved[128 - 48 - 8 * kPriceColumns];
+};
+static_assert(sizeof(PriceFileHeader) == 128, "PriceFileHeader is part of the file format");
+
+namespace price_detail {
+
+inline std::uint64_t alignUp(std::uint64_t value) {
+    return (value + PriceFileHeader::kAlignment - 1) / PriceFileHeader::kAlignment * PriceFileHeader::kAlignment;
+}
+
+// Header with the column offsets of a file with `rows` rows
+inline PriceFileHeader layout(std::uint64_t rows, std::uint32_t valueBytes) {
+    PriceFileHeader h{};
+    std::memcpy(h.magic, PriceFileHeader::kMagic, sizeof(h.magic));
+    h.version = PriceFileHeader::kVersion;
+    h.byteOrder = PriceFileHeader::kByteOrder;
+    h.rows = rows;
+    h.valueBytes = valueBytes;
+    h.headerBytes = sizeof(PriceFileHeader);
+    std::uint64_t offset = alignUp(sizeof(PriceFileHeader));
+    for (std::uint32_t c = 0; c < kPriceColumns; ++c) {
+        h.offsets[c] = offset;
+        offset = alignUp(offset + rows * (c == kTimeColumn ? sizeof(std::int64_t) : valueBytes));
+    }
+    return h;
+}
+
+inline std::uint64_t fileBytes(const PriceFileHeader& h) {
+    return alignUp(h.offsets[kVolumeColumn] + h.rows * h.valueBytes);
+}
+
+inline bool writeAll(int fd, const void* data, std::size_t bytes, std::uint64_t offset) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes) {
+        ssize_t n = ::pwrite(fd, p, bytes, off_t(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        bytes -= std::size_t(n);
+        offset += std::uint64_t(n);
+    }
+    return true;
+}
+
+}  // namespace price_detail
+
+// Writes a price file; high, low and volume may be null (stored as NaN). Returns 0 or an errno value.
+template <typename T>
+int writePriceFile(const char* path, const std::int64_t* time, const T* close, const T* high, const T* low,
+                   const T* volume, std::size_t rows) {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "price columns are float32 or float64");
+    for (std::size_t i = 1; i < rows; ++i) {
+        if (time[i] < time[i - 1]) return EINVAL;  // The time index must be sorted
+    }
+    PriceFileHeader h = price_detail::layout(rows, sizeof(T));
+    h.firstTime = rows ? time[0] : 0;
+    h.lastTime = rows ? time[rows - 1] : 0;
+
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return errno;
+    int err = 0;
+    if (::ftruncate(fd, off_t(price_detail::fileBytes(h))) != 0) err = errno;
+    const void* columns[kPriceColumns] = {time, close, high, low, volume};
+    T missing[1024];
+    std::fill(std::begin(missing), std::end(missing), std::numeric_limits<T>::quiet_NaN());
+    for (std::uint32_t c = 0; c < kPriceColumns && !err; ++c) {
+        std::size_t width = c == kTimeColumn ? sizeof(std::int64_t) : sizeof(T);
+        if (columns[c]) {
+            if (!price_detail::writeAll(fd, columns[c], rows * width, h.offsets[c])) err = errno ? errno : EIO;
+            continue;
+        }
+        for (std::size_t done = 0; done < rows && !err; done += 1024) {  // Absent column: NaN
+            std::size_t chunk = std::min<std::size_t>(1024, rows - done);
+            if (!price_detail::writeAll(fd, missing, chunk * width, h.offsets[c] + done * width)) {
+                err = errno ? errno : EIO;
+            }
+        }
+    }
+    // The header goes last: a file cut short by a crash has no valid magic
+    if (!err && !price_detail::writeAll(fd, &h, sizeof(h), 0)) err = errno ? errno : EIO;
+    if (::close(fd) != 0 && !err) err = errno;
+    return err;
+}
+
+class PriceFile {
+public:
+    PriceFile() = default;
+    explicit PriceFile(const char* path) { open(path); }
+    PriceFile(PriceFile&& other) noexcept { *this = std::move(other); }
+    PriceFile& operator=(PriceFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            base_ = std::exchange(other.base_, nullptr);
+            bytes_ = std::exchange(other.bytes_, 0);
+            header_ = other.header_;
+            error_ = other.error_;
+        }
+        return *this;
+    }
+    PriceFile(const PriceFile&) = delete;
+    PriceFile& operator=(const PriceFile&) = delete;
+    ~PriceFile() { unmap(); }
+
+    // Maps path read-only and validates the header; returns 0 or an errno value (EINVAL: not a valid file)
+    int open(const char* path) {
+        unmap();
+        error_ = map(path);
+        return error_;
+    }
+
+    int error() const { return error_; }
+    bool isOpen() const { return base_ != nullptr; }
+    std::size_t rows() const { return std::size_t(header_.rows); }
+    std::uint32_t valueBytes() const { return header_.valueBytes; }
+    const PriceFileHeader& header() const { return header_; }
+
+    const std::int64_t* time() const { return static_cast<const std::int64_t*>(at(kTimeColumn)); }
+
+    // A price/volume column; nullptr if the file stores the other float width
+    template <typename T>
+    const T* column(PriceColumn c) const {
+        if (c == kTimeColumn || sizeof(T) != header_.valueBytes) return nullptr;
+        return static_cast<const T*>(at(c));
+    }
+
+    // Rows [first, last) whose time is in [from, to)
+    std::pair<std::size_t, std::size_t> rowsBetween(std::int64_t from, std::int64_t to) const {
+        const std::int64_t* begin = time();
+        const std::int64_t* end = begin + rows();
+        if (!begin) return {0, 0};
+        std::size_t first = std::size_t(std::lower_bound(begin, end, from) - begin);
+        std::size_t last = std::size_t(std::lower_bound(begin + first, end, to) - begin);
+        return {first, last};
+    }
+
+    // Hints the kernel to read a column ahead (sequential scans of a cold file)
+    void willNeed(PriceColumn c) const {
+        if (!base_) return;
+        std::uint64_t width = c == kTimeColumn ? sizeof(std::int64_t) : header_.valueBytes;
+        std::uint64_t page = std::uint64_t(::sysconf(_SC_PAGESIZE));
+        std::uint64_t start = header_.offsets[c] / page * page;
+        ::posix_madvise(static_cast<char*>(base_) + start, header_.offsets[c] + header_.rows * width - start,
+                        POSIX_MADV_WILLNEED);
+    }
+
+private:
+    const void* at(PriceColumn c) const {
+        return base_ ? static_cast<const char*>(base_) + header_.offsets[c] : nullptr;
+    }
+
+    int map(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return errno;
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            return err;
+        }
+        if (std::uint64_t(st.st_size) < sizeof(PriceFileHeader)) {
+            ::close(fd);
+            return EINVAL;
+        }
+        void* base = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        int err = base == MAP_FAILED ? errno : 0;
+        ::close(fd);  // The mapping keeps the file
+        if (err) return err;
+
+        std::memcpy(&header_, base, sizeof(header_));
+        if (!valid(header_, std::uint64_t(st.st_size))) {
+            ::munmap(base, std::size_t(st.st_size));
+            header_ = PriceFileHeader{};
+            return EINVAL;
+        }
+        base_ = base;
+        bytes_ = std::size_t(st.st_size);
+        return 0;
+    }
+
+    static bool valid(const PriceFileHeader& h, std::uint64_t size) {
+        if (std::memcmp(h.magic, PriceFileHeader::kMagic, sizeof(h.magic)) != 0) return false;
+        if (h.version != PriceFileHeader::kVersion || h.byteOrder != PriceFileHeader::kByteOrder) return false;
+        if (h.valueBytes != 4 && h.valueBytes != 8) return false;
+        if (h.rows > size) return false;  // Also keeps the offset arithmetic below from overflowing
+        PriceFileHeader expected = price_detail::layout(h.rows, h.valueBytes);
+        return std::memcmp(h.offsets, expected.offsets, sizeof(h.offsets)) == 0 && price_detail::fileBytes(h) <= size;
+    }
+
+    void unmap() {
+        if (base_) ::munmap(base_, bytes_);
+        base_ = nullptr;
+        bytes_ = 0;
+        header_ = PriceFileHeader{};
+    }
+
+    void* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    PriceFileHeader header_{};
+    int error_ = 0;
+};
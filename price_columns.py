@@ -0,0 +1,281 @@
+"""Memory-mapped columnar price files (format: price_columns.hpp).
+
+Convert once, then map instead of loading:
+
+    import price_columns as pc
+    pc.convert_csv('history.csv', 'history.pxcol', time_column='Date')   # or pc.from_dataframe(df, ...)
+    with pc.PriceFile('history.pxcol') as prices:
+        first, last = prices.rows_between(start_ns, end_ns)
+        mask = indicator_engine.filter_mask(prices.close[first:last])   # No copy, no parsing
+        close = prices.series('close')                                  # pandas Series over the mapping
+        data = prices.to_dataframe()                                    # Copies the value columns into RAM
+
+Columns are NumPy arrays over the mapping when NumPy is available, memoryviews otherwise; both can be
+passed to indicator_engine directly. The mapping is private (copy-on-write), so it is never written back.
+"""
+
+import bisect
+import csv
+import math
+import mmap
+import os
+import struct
+from array import array
+from datetime import datetime, timezone
+
+try:
+    import numpy as _np
+except ImportError:
+    _np = None
+
+MAGIC = b'PXCOLS\r\n'
+VERSION = 1
+BYTE_ORDER = 0x01020304
+ALIGNMENT = 64
+COLUMNS = ('time', 'close', 'high', 'low', 'volume')
+
+# struct PriceFileHeader: magic, version, byteOrder, rows, valueBytes, headerBytes, firstTime, lastTime, offsets[5]
+_HEADER = struct.Struct('<8sIIQIIqq5Q40x')
+assert _HEADER.size == 128
+
+
+def _align(value):
+    return (value + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+def _layout(rows, value_bytes):
+    """Column offsets and total file size, as price_detail::layout() computes them."""
+    offsets = []
+    offset = _align(_HEADER.size)
+    for name in COLUMNS:
+        offsets.append(offset)
+        offset = _align(offset + rows * (8 if name == 'time' else value_bytes))
+    return offsets, offset
+
+
+def _typecode(dtype):
+    if dtype not in ('d', 'f'):
+        raise ValueError("dtype must be 'd' (float64) or 'f' (float32)")
+    return dtype
+
+
+def _write_header(f, rows, value_bytes, first_time, last_time, offsets):
+    f.seek(0)
+    f.write(_HEADER.pack(MAGIC, VERSION, BYTE_ORDER, rows, value_bytes, _HEADER.size, first_time, last_time,
+                         *offsets))
+
+
+def _column_bytes(values, typecode, rows):
+    """Raw little-endian bytes of one column (NaN-filled when values is None)."""
+    if values is None:
+        return (array(typecode, [math.nan]) * rows).tobytes()
+    if _np is not None and hasattr(values, 'dtype'):
+        data = _np.ascontiguousarray(values, dtype='<' + typecode)
+    else:
+        data = values if isinstance(values, array) and values.typecode == typecode else array(typecode, values)
+    if len(data) != rows:
+        raise ValueError('write_price_file: columns differ in length')
+    return data.tobytes()
+
+
+def _is_sorted(times):
+    if _np is not None and hasattr(times, 'dtype'):
+        return not (len(times) > 1 and (_np.diff(times) < 0).any())
+    return all(times[i] >= times[i - 1] for i in range(1, len(times)))
+
+
+def write_price_file(path, time_ns, close, high=None, low=None, volume=None, dtype='d'):
+    """Writes in-memory columns (sequences or NumPy arrays); time_ns must be non-decreasing.
+    Missing columns are stored as NaN."""
+    typecode = _typecode(dtype)
+    rows = len(time_ns)
+    if not _is_sorted(time_ns):
+        raise ValueError('write_price_file: the time index must be sorted')
+    value_bytes = array(typecode).itemsize
+    offsets, size = _layout(rows, value_bytes)
+    with open(path, 'wb') as f:
+        f.truncate(size)
+        f.seek(offsets[0])
+        f.write(_column_bytes(time_ns, 'q', rows))
+        for offset, values in zip(offsets[1:], (close, high, low, volume)):
+            f.seek(offset)
+            f.write(_column_bytes(values, typecode, rows))
+        # The header goes last: a file cut short has no valid magic
+        first, last = (int(time_ns[0]), int(time_ns[-1])) if rows else (0, 0)
+        _write_header(f, rows, value_bytes, first, last, offsets)
+
+
+def parse_time(text, unit='s'):
+    """Epoch number in `unit` (s, ms, us, ns) or an ISO 8601 date/time (UTC if naive) -> nanoseconds."""
+    scale = {'s': 10**9, 'ms': 10**6, 'us': 10**3, 'ns': 1}[unit]
+    text = text.strip()
+    try:
+        return int(text) * scale
+    except ValueError:
+        pass
+    try:
+        return int(round(float(text) * scale))
+    except ValueError:
+        pass
+    moment = datetime.fromisoformat(text)
+    if moment.tzinfo is None:
+        moment = moment.replace(tzinfo=timezone.utc)
+    delta = moment - datetime(1970, 1, 1, tzinfo=timezone.utc)
+    return (delta.days * 86400 + delta.seconds) * 10**9 + delta.microseconds * 1000
+
+
+def convert_csv(csv_path, out_path, time_column=None, close_column='Close', high_column='High', low_column='Low',
+                volume_column='Volume', time_unit='s', dtype='d', chunk_rows=1 << 16):
+    """Converts a CSV file with a header row in two streaming passes (memory use is independent of size).
+
+    time_column defaults to the first column. Missing High/Low/Volume columns are stored as NaN;
+    empty cells too. Returns the number of rows written.
+    """
+    typecode = _typecode(dtype)
+    with open(csv_path, newline='') as f:
+        reader = csv.reader(f)
+        header = next(reader)
+        rows = sum(1 for row in reader if row)
+    time_column = time_column or header[0]
+    if time_column not in header or close_column not in header:
+        raise ValueError('convert_csv: %s has no %r or %r column' % (csv_path, time_column, close_column))
+    fields = [time_column, close_column, high_column, low_column, volume_column]
+    indexes = [header.index(name) if name in header else None for name in fields]
+
+    value_bytes = array(typecode).itemsize
+    offsets, size = _layout(rows, value_bytes)
+    written = [0] * len(COLUMNS)
+    first_time = last_time = None
+    try:
+        with open(csv_path, newline='') as src, open(out_path, 'wb') as out:
+            out.truncate(size)
+            reader = csv.reader(src)
+            next(reader)
+            chunks = [array('q')] + [array(typecode) for _ in COLUMNS[1:]]
+
+            def flush():
+                for c, chunk in enumerate(chunks):
+                    out.seek(offsets[c] + written[c] * chunk.itemsize)
+                    out.write(chunk.tobytes())
+                    written[c] += len(chunk)
+                    del chunk[:]
+
+            for row in reader:
+                if not row:
+                    continue
+                t = parse_time(row[indexes[0]], time_unit)
+                if last_time is not None and t < last_time:
+                    raise ValueError('convert_csv: %s is not sorted by %r' % (csv_path, time_column))
+                first_time = t if first_time is None else first_time
+                last_time = t
+                chunks[0].append(t)
+                for c in range(1, len(COLUMNS)):
+                    cell = row[indexes[c]] if indexes[c] is not None else ''
+                    chunks[c].append(float(cell) if cell.strip() else math.nan)
+                if len(chunks[0]) >= chunk_rows:
+                    flush()
+            flush()
+            _write_header(out, rows, value_bytes, first_time or 0, last_time or 0, offsets)
+    except Exception:
+        if os.path.exists(out_path):
+            os.remove(out_path)
+        raise
+    return rows
+
+
+def from_dataframe(df, path, dtype='d'):
+    """Writes a DataFrame with a Close column (High/Low/Volume optional) and a sorted DatetimeIndex."""
+    times = df.index.asi8 if hasattr(df.index, 'asi8') else list(range(len(df)))  # No time index: row numbers
+    columns = [df[name].to_numpy(dtype='float64') if name in df else None
+               for name in ('Close', 'High', 'Low', 'Volume')]
+    write_price_file(path, times, *columns, dtype=dtype)
+
+
+class PriceFile:
+    """Read-only view of a price file: time, close, high, low and volume map the file without copying."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY)
+        try:
+            self._parse(path)
+        except Exception:
+            self._map.close()
+            raise
+
+    def _parse(self, path):
+        if len(self._map) < _HEADER.size:
+            raise ValueError('%s: not a price file' % path)
+        (magic, version, byte_order, rows, value_bytes, header_bytes, self.first_time, self.last_time,
+         *offsets) = _HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC or version != VERSION or byte_order != BYTE_ORDER or value_bytes not in (4, 8):
+            raise ValueError('%s: not a price file (or another version / byte order)' % path)
+        expected, size = _layout(rows, value_bytes)
+        if list(offsets) != expected or size > len(self._map):
+            raise ValueError('%s: truncated or inconsistent price file' % path)
+        self.rows = rows
+        self.value_bytes = value_bytes
+        self.dtype = 'd' if value_bytes == 8 else 'f'
+        self._views = {}
+        for name, offset in zip(COLUMNS, offsets):
+            code = 'q' if name == 'time' else self.dtype
+            if _np is not None:
+                view = _np.frombuffer(self._map, dtype='<' + code, count=rows, offset=offset)
+                view.flags.writeable = False
+            else:
+                width = 8 if name == 'time' else value_bytes
+                view = memoryview(self._map)[offset:offset + rows * width].cast(code)
+            self._views[name] = view
+
+    time = property(lambda self: self._views['time'], doc='int64 nanoseconds since the epoch')
+    close = property(lambda self: self._views['close'])
+    high = property(lambda self: self._views['high'])
+    low = property(lambda self: self._views['low'])
+    volume = property(lambda self: self._views['volume'])
+
+    def rows_between(self, start_ns, end_ns):
+        """(first, last) rows whose time is in [start_ns, end_ns), by binary search of the time index."""
+        times = self._views['time']
+        if _np is not None:
+            return int(_np.searchsorted(times, start_ns)), int(_np.searchsorted(times, end_ns))
+        first = bisect.bisect_left(times, start_ns)
+        return first, bisect.bisect_left(times, end_ns, first)
+
+    def index(self):
+        """DatetimeIndex over the mapped time column (reinterpreted as datetime64[ns], not converted)."""
+        import pandas as pd  # pandas requires NumPy, so the columns are NumPy views here
+        return pd.DatetimeIndex(self.time.view('datetime64[ns]'), copy=False)
+
+    def series(self, name, index=None):
+        """One column as a pandas Series that is a view of the mapping (no copy); name is one of COLUMNS."""
+        import pandas as pd
+        return pd.Series(self._views[name], index=self.index() if index is None else index, name=name.capitalize(),
+                         copy=False)
+
+    def to_dataframe(self):
+        """DataFrame with Close, High, Low and Volume on a DatetimeIndex.
+
+        This copies the four value columns into RAM: pandas stores same-dtype columns as one 2-D block.
+        For histories that should stay on disk, use the column views or series() instead.
+        """
+        import pandas as pd
+        index = self.index()
+        return pd.DataFrame({name.capitalize(): self.series(name, index) for name in COLUMNS[1:]}, index=index)
+
+    def close_file(self):
+        """Releases the mapping; views obtained earlier must no longer be used."""
+        views, self._views = self._views, {}
+        for view in views.values():
+            if isinstance(view, memoryview):
+                view.release()
+        del views
+        try:
+            self._map.close()
+        except BufferError:  # NumPy views still alive: the mapping goes when they do
+            pass
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close_file()
@@ -1,29 +1,126 @@
+/*Hard Real-Time Scheduling - Periodic Tasks with Measured Jitter, WCET and Deadline Misses
+A hard real-time task must finish every release before its deadline; one late result is a failure.
+Checking the deadline once, in milliseconds, after a sleep_for() says nothing about how the task
+behaves over thousands of releases, and it cannot see microsecond-level jitter.
+
+PeriodicExecutor (rt_executor.hpp) releases each task at absolute times with clock_nanosleep(TIMER_ABSTIME),
+so the schedule does not drift, and records jitter, execution time and deadline misses in nanoseconds.
+All tasks run SCHED_FIFO on CPU 0 with rate-monotonic priorities (shorter period = higher priority),
+and all memory is locked and pre-faulted before the first release. Run as root (or with
+CAP_SYS_NICE and CAP_IPC_LOCK) for that to take effect; otherwise the report shows a warning.
+Usage: ./qnx_hard_time_scheduling [seconds]*/
+
 #include <iostream>
-#include <thread>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-void hardRealTimeTask() {
-    auto start_time = std::chrono::steady_clock::now();
-    
-    // Task execution
-    std::cout << "Executing Hard Real-Time Task\n";
-    
-    // Simulate processing
-    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Simulating work
-
-    auto end_time = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-
-    // Strict deadline enforcement (e.g., must finish within 20ms)
-    if (duration > 20) {
-        std::cerr << "Deadline Missed! System Failure!\n";
-    } else {
-        std::cout << "Task completed within deadline.\n";
+#include "rt_executor.hpp"
+#include "schedulability.hpp"
+
+// Simulated computation: burns CPU for the given time, like a real control law would.
+// (sleep_for() releases the CPU, so it hides exactly the interference we want to measure.)
+static void busyWork(std::chrono::microseconds amount) {
+    std::int64_t end = rt_detail::nowNs() + std::chrono::duration_cast<std::chrono::nanoseconds>(amount).count();
+    while (rt_detail::nowNs() < end) {
     }
 }
 
-int main() {
-    std::cout << "Starting Hard Real-Time Task...\n";
-    hardRealTimeTask();
+void hardRealTimeTask() {
+    busyWork(std::chrono::microseconds(2000));  // Must finish within its 5 ms deadline every 10 ms period
+}
+
+// Usually 1 ms, but every 25th release hits a slow path that blows its 8 ms deadline
+void trajectoryPlanner() {
+    static int release = 0;
+    busyWork(std::chrono::microseconds(++release % 25 == 0 ? 10000 : 1000));
+}
+
+// Degraded mode: reuse the previous trajectory instead of planning a new one
+void holdTrajectory() {
+    busyWork(std::chrono::microseconds(200));
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 2;
+    std::cout << "Starting Hard Real-Time Tasks for " << seconds << " s..." << std::endl;
+
+    using std::chrono::microseconds;
+    using std::chrono::milliseconds;
+    int err = lockMemory();
+    if (err != 0) {
+        std::cerr << "mlockall failed: " << std::strerror(err) << " (page faults may cause misses)\n";
+    }
+
+    TaskConfig control;
+    control.policy = SCHED_FIFO;
+    control.priority = 50;
+    control.cpu = 0;
+    TaskConfig sensor = control;
+    sensor.priority = 60;  // 1 ms period beats the 10 ms one
+    TaskConfig planner = control;
+    planner.priority = 40;
+
+    PeriodicExecutor executor(90);  // Overrun handling outranks every task
+    std::atomic<int> escalations{0};
+    executor.setSupervisor([&escalations](const PeriodicExecutor::Task& task) {
+        // Runs while the task is still overrunning: this is where actuators would be put in a safe state
+        escalations++;
+        std::fprintf(stderr, "Deadline Missed! System Failure! (%s still running)\n", task.name.c_str());
+    });
+    auto& controlTask = executor.addTask("control", milliseconds(10), milliseconds(5), hardRealTimeTask, control);
+    auto& sensorTask =
+        executor.addTask("sensor", milliseconds(1), microseconds(0), [] { busyWork(microseconds(100)); }, sensor);
+    auto& plannerTask = executor.addTask("planner", milliseconds(20), milliseconds(8), trajectoryPlanner, planner);
+    executor.setOverrunPolicy(controlTask, OverrunPolicy::Escalate);
+    executor.setOverrunPolicy(sensorTask, OverrunPolicy::SkipNextRelease);
+    executor.setOverrunPolicy(plannerTask, OverrunPolicy::Fallback, holdTrajectory);
+    executor.run(std::chrono::seconds(seconds));
+    executor.printReport();
+
+    // Same task set, analyzed with the measured WCETs (+20% margin): how much more fits on CPU 0?
+    // The planner's measured WCET is its slow path, which is exactly what the analysis must assume.
+    std::vector<TaskTiming> cpu0 = fromExecutor(executor, 0, 1.2);
+    printSchedulability(analyzeFixedPriority(cpu0));  // The configured priorities, which are rate-monotonic here
+    printSchedulability(analyzeEdf(cpu0));
+
+    if (escalations > 0) {
+        return 1;
+    }
+    std::cout << "No escalations: every overrun was handled by its task's policy.\n";
     return 0;
 }
+
+/*Why absolute release times?
+sleep_for(period) after the work starts the next period late by the work time plus the wake-up latency,
+and every period adds to the error. Releasing at first + n * period with TIMER_ABSTIME keeps each
+release on the grid; a late wake-up shows up as jitter in that one release and is not carried forward.
+
+What the report means
+jitter   - how late the task started after its scheduled release (scheduler and timer latency)
+exec     - how long the body ran; WCET is the largest value seen, an observation, not a proof
+misses   - releases that finished after release + deadline
+On a desktop OS without real-time priorities expect occasional jitter in the hundreds of microseconds;
+on QNX (or with SCHED_FIFO) the same tasks should stay in the low microseconds.
+
+Why SCHED_FIFO, affinity and mlockall?
+Under SCHED_OTHER any busy normal thread gets a time slice in the middle of a release.
+A SCHED_FIFO thread runs until it blocks or a higher priority thread becomes ready, so only
+higher-priority real-time work can delay it. Pinning keeps its cache warm and its timing repeatable,
+and locking + pre-faulting memory removes page faults, which can cost tens of microseconds each.
+
+Why catch overruns in flight?
+Checking the deadline after the task returns tells you about a failure that has already reached the
+actuators. The watchdog timer fires at the deadline itself, so the supervisor can act while the task is
+still running (control escalates), and the task's next release can be adapted to recover the schedule:
+the sensor skips one release, the planner switches to its cheap fallback for one release.
+
+Reading the schedulability report
+Fixed priority: R is the worst-case response time when every task is released at once (the critical
+instant); slack = deadline - R. Extra budget is how much longer that one task could run before some
+task on the core misses, i.e. the room left for new work at that priority.
+EDF: the same tasks under earliest-deadline-first scheduling; it can use the core up to U = 1,
+so it usually shows more room than rate-monotonic. The planner's slow path makes the set
+unschedulable on paper, which is why it needs an overrun policy in practice.*/
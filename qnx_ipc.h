@@ -0,0 +1,467 @@
+/*QNX IPC Protocol - Shared by the Server and Client in QNX_ipc.cpp
+Every message starts with an int msg_type so the server can tell them apart after MsgReceive().
+User message types stay below _IO_BASE (0x100) so they never collide with QNX system messages.
+
+Shared-memory bulk transfer:
+MsgSend() copies the whole message through the kernel, and MsgReply() copies the reply back.
+For megabyte camera frames, that copying costs more than the work. Instead:
+1. The client creates a shared-memory region (shm_open + mmap) and writes frames straight into it.
+2. MSG_SHM_ATTACH tells the server the region's name once; the server maps it read-only.
+3. Per frame, only a small ShmFrameMsg descriptor (offset, length, generation) goes over the channel.
+The generation number is a seqlock: ipc_shm_begin_frame() makes it odd before the client writes,
+ipc_shm_send_frame() makes it even (release) once the frame is complete. The server loads it (acquire)
+before and after reading and rejects the frame if it was odd or changed: the client was rewriting it.
+
+Header + payload (scatter/gather) messaging:
+Message is a fixed 104-byte struct, so "Hello, Server!" still copies 104 bytes each way plus a strcpy().
+MSG_RECORD sends a MsgHeader followed by exactly payload_len bytes, gathered from separate buffers
+with MsgSendv()/SETIOV, and the reply comes back the same way with MsgReplyv().
+The server receives the header plus up to SERVER_INLINE_PAYLOAD bytes; larger payloads stay in the
+client's address space until the server pulls them with MsgRead() straight into their destination.
+
+Pulses and events (fire-and-forget):
+A pulse (MsgSendPulse) is a tiny non-blocking message: an 8-bit code plus a 32-bit value,
+queued by the kernel. The server sees it as rcvid == 0 and never replies.
+MSG_ASYNC_JOB carries a sigevent; the server replies at once, does the work later, and reports
+completion with MsgDeliverEvent(), which the client picks up as a pulse on its own channel.
+
+Name-based discovery:
+The server registers a name with name_attach() (default IPC_SERVER_NAME, several instances can use
+different names) and receives on the attach's chid. Clients resolve it with name_open() through an
+IpcConnection, which keeps the coid for reuse and reconnects when the server has restarted.
+
+Cross-node (Qnet):
+An IpcConnection can also point at a server on another node: netmgr_strtond() turns the node name
+into a node descriptor and ConnectAttach(nd, pid, chid) connects across Qnet. The same Msg*() calls work.
+Every MsgSend() to another node is a network round trip, so IpcBatch packs many small records into
+one MSG_BATCH message: one round trip, one reply with per-batch totals.
+
+Deadlines:
+MsgHeader carries an optional absolute deadline (CLOCK_MONOTONIC ns, 0 = none). The server rejects
+a request whose deadline has already passed with MsgError(ETIMEDOUT) before doing any work on it,
+so a late request costs the server microseconds instead of delaying the next one.
+Deadlines compare clocks on one node; do not set them on requests sent over Qnet.*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/neutrino.h>
+#include <sys/netmgr.h>
+#include <sys/dispatch.h>
+
+#define IPC_SERVER_NAME "qnx_ipc"       // Default name_attach() / name_open() name
+#define IPC_NAME_MAX 64
+#define IPC_RECONNECT_ATTEMPTS 50       // name_open() retries while a server restarts...
+#define IPC_RECONNECT_DELAY_US 100000   // ...100ms apart (5s in total)
+
+enum MsgType {
+    MSG_TEXT = 1,        // Message: short text, copied through the kernel
+    MSG_SHM_ATTACH = 2,  // ShmAttachMsg -> ShmAttachReply
+    MSG_SHM_FRAME = 3,   // ShmFrameMsg -> ShmFrameReply
+    MSG_SHM_DETACH = 4,  // ShmDetachMsg -> no data
+    MSG_RECORD = 5,      // MsgHeader + payload -> MsgHeader + payload
+    MSG_ASYNC_JOB = 6,   // AsyncJobMsg -> immediate empty reply, later MsgDeliverEvent()
+    MSG_BATCH = 7,       // MsgHeader + BatchEntry records -> BatchReply
+};
+
+enum PulseCode {
+    PULSE_CODE_TELEMETRY = _PULSE_CODE_MINAVAIL,  // value = telemetry sample, client -> server
+    PULSE_CODE_JOB_DONE,                          // value = job id, server -> client (via sigevent)
+};
+
+typedef struct {
+    int msg_type;
+    char text[100];
+} Message;
+
+// ----- Connection cache -----
+
+typedef struct {
+    char name[IPC_NAME_MAX];
+    char node[IPC_NAME_MAX];  // Empty: local server found by name; otherwise a Qnet node name
+    pid_t pid;                // Remote server's pid and chid (printed by the server at startup)
+    int chid;
+    int coid;                 // -1 until resolved
+    pthread_mutex_t lock;     // Serialises (re)connects; sends on the coid need no lock
+} IpcConnection;
+
+static inline void ipc_connection_init(IpcConnection* conn, const char* name) {
+    snprintf(conn->name, sizeof(conn->name), "%s", name);
+    conn->node[0] = '\0';
+    conn->pid = 0;
+    conn->chid = -1;
+    conn->coid = -1;
+    pthread_mutex_init(&conn->lock, NULL);
+}
+
+// Server on another node, reached through Qnet
+static inline void ipc_connection_init_remote(IpcConnection* conn, const char* node, pid_t pid, int chid) {
+    ipc_connection_init(conn, "");
+    snprintf(conn->node, sizeof(conn->node), "%s", node);
+    conn->pid = pid;
+    conn->chid = chid;
+}
+
+static inline int ipc_connection_open(const IpcConnection* conn) {
+    if (conn->node[0] == '\0') {
+        return name_open(conn->name, 0);
+    }
+    // Resolved on every (re)connect: node descriptors are only valid while the Qnet link is up
+    int nd = netmgr_strtond(conn->node, NULL);
+    if (nd == -1) {
+        return -1;
+    }
+    return ConnectAttach(nd, conn->pid, conn->chid, _NTO_SIDE_CHANNEL, 0);
+}
+
+static inline void ipc_connection_release(const IpcConnection* conn, int coid) {
+    if (conn->node[0] == '\0') {
+        name_close(coid);
+    } else {
+        ConnectDetach(coid);
+    }
+}
+
+// Returns the cached coid, connecting on first use. -1 on failure.
+static inline int ipc_connection_coid(IpcConnection* conn) {
+    pthread_mutex_lock(&conn->lock);
+    if (conn->coid == -1) {
+        conn->coid = ipc_connection_open(conn);
+    }
+    int coid = conn->coid;
+    pthread_mutex_unlock(&conn->lock);
+    return coid;
+}
+
+// Call after a failed send on failed_coid with the errno it produced.
+// If the server went away (EBADF/ESRCH), reconnects and returns 1 so the caller can retry; otherwise 0.
+// Only retry requests that are safe to repeat: the old server may have processed it before dying.
+static inline int ipc_connection_recover(IpcConnection* conn, int err, int failed_coid) {
+    if (err != EBADF && err != ESRCH) {
+        return 0;
+    }
+    pthread_mutex_lock(&conn->lock);
+    if (conn->coid == failed_coid) {  // Not already replaced by another thread
+        if (conn->coid != -1) {
+            ipc_connection_release(conn, conn->coid);
+        }
+        conn->coid = -1;
+        for (int attempt = 0; attempt < IPC_RECONNECT_ATTEMPTS && conn->coid == -1; attempt++) {
+            conn->coid = ipc_connection_open(conn);
+            if (conn->coid == -1) {
+                usleep(IPC_RECONNECT_DELAY_US);
+            }
+        }
+    }
+    int ok = conn->coid != -1;
+    pthread_mutex_unlock(&conn->lock);
+    return ok;
+}
+
+static inline void ipc_connection_close(IpcConnection* conn) {
+    pthread_mutex_lock(&conn->lock);
+    if (conn->coid != -1) {
+        ipc_connection_release(conn, conn->coid);
+        conn->coid = -1;
+    }
+    pthread_mutex_unlock(&conn->lock);
+}
+
+// Process-wide cache: every caller asking for the same name shares one resolved connection
+#define IPC_CONNECTION_CACHE_SIZE 8
+
+static inline IpcConnection* ipc_connection_cached(const char* name) {
+    static IpcConnection cache[IPC_CONNECTION_CACHE_SIZE];
+    static int used;
+    static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+    IpcConnection* conn = NULL;
+    pthread_mutex_lock(&cache_lock);
+    for (int i = 0; i < used && conn == NULL; i++) {
+        if (strcmp(cache[i].name, name) == 0) {
+            conn = &cache[i];
+        }
+    }
+    if (conn == NULL && used < IPC_CONNECTION_CACHE_SIZE) {
+        conn = &cache[used++];
+        ipc_connection_init(conn, name);
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return conn;  // NULL only when the cache is full
+}
+
+// ----- Header + payload records -----
+
+typedef struct {
+    int msg_type;
+    uint32_t payload_len;  // Bytes that follow the header
+    uint64_t deadline_ns;  // Absolute CLOCK_MONOTONIC time, 0 = no deadline
+} MsgHeader;
+
+static inline uint64_t ipc_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#define SERVER_INLINE_PAYLOAD 512  // Payload bytes received together with the header
+
+// Sends header + payload as two IOVs and gathers the reply the same way.
+// Returns the reply's payload length (it may exceed reply_cap; only reply_cap bytes are copied), or -1
+// (errno ETIMEDOUT if the server received it after deadline_ns).
+static inline long ipc_send_record_deadline(int coid, int msg_type, const void* payload, uint32_t len,
+                                            uint64_t deadline_ns, void* reply_buf, uint32_t reply_cap) {
+    MsgHeader header = { msg_type, len, deadline_ns };
+    MsgHeader reply_header = { 0, 0, 0 };
+    iov_t siov[2];
+    iov_t riov[2];
+    SETIOV(&siov[0], &header, sizeof(header));
+    SETIOV(&siov[1], payload, len);
+    SETIOV(&riov[0], &reply_header, sizeof(reply_header));
+    SETIOV(&riov[1], reply_buf, reply_cap);
+    if (MsgSendv(coid, siov, 2, riov, 2) == -1) {
+        return -1;
+    }
+    return reply_header.payload_len;
+}
+
+static inline long ipc_send_record(int coid, int msg_type, const void* payload, uint32_t len,
+                                   void* reply_buf, uint32_t reply_cap) {
+    return ipc_send_record_deadline(coid, msg_type, payload, len, 0, reply_buf, reply_cap);
+}
+
+// ----- Batching -----
+
+// One record inside a MSG_BATCH payload; entries are padded to 4-byte boundaries
+typedef struct {
+    uint16_t msg_type;  // Currently MSG_RECORD
+    uint16_t len;       // Payload bytes that follow this entry header
+} BatchEntry;
+
+typedef struct {
+    uint32_t processed;
+    uint32_t rejected;
+} BatchReply;
+
+#define IPC_BATCH_MAX_BYTES 8192
+#define IPC_BATCH_ALIGN(n) (((n) + 3u) & ~3u)
+
+typedef struct {
+    IpcConnection* conn;
+    size_t used;
+    uint32_t entries;
+    uint64_t round_trips;      // Batches actually sent
+    uint64_t total_processed;  // Sum of BatchReply.processed
+    unsigned char buf[IPC_BATCH_MAX_BYTES];
+} IpcBatch;
+
+static inline void ipc_batch_init(IpcBatch* batch, IpcConnection* conn) {
+    batch->conn = conn;
+    batch->used = 0;
+    batch->entries = 0;
+    batch->round_trips = 0;
+    batch->total_processed = 0;
+}
+
+// Sends everything queued as one message. Returns 0 or -1.
+static inline int ipc_batch_flush(IpcBatch* batch) {
+    if (batch->entries == 0) {
+        return 0;
+    }
+    MsgHeader header = { MSG_BATCH, (uint32_t)batch->used, 0 };
+    BatchReply reply;
+    iov_t siov[2];
+    SETIOV(&siov[0], &header, sizeof(header));
+    SETIOV(&siov[1], batch->buf, batch->used);
+    long rc;
+    int coid;
+    do {
+        coid = ipc_connection_coid(batch->conn);
+        rc = coid == -1 ? -1 : MsgSendvs(coid, siov, 2, &reply, sizeof(reply));
+    } while (rc == -1 && ipc_connection_recover(batch->conn, errno, coid));
+    batch->used = 0;
+    batch->entries = 0;
+    if (rc == -1) {
+        return -1;
+    }
+    batch->round_trips++;
+    batch->total_processed += reply.processed;
+    return 0;
+}
+
+// Queues one record, flushing first if it would not fit. Returns 0 or -1.
+static inline int ipc_batch_add(IpcBatch* batch, const void* payload, uint16_t len) {
+    size_t need = IPC_BATCH_ALIGN(sizeof(BatchEntry) + len);
+    if (need > IPC_BATCH_MAX_BYTES) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if (batch->used + need > IPC_BATCH_MAX_BYTES && ipc_batch_flush(batch) == -1) {
+        return -1;
+    }
+    BatchEntry entry = { MSG_RECORD, len };
+    memcpy(batch->buf + batch->used, &entry, sizeof(entry));
+    memcpy(batch->buf + batch->used + sizeof(entry), payload, len);
+    batch->used += need;
+    batch->entries++;
+    return 0;
+}
+
+// ----- Asynchronous jobs -----
+
+typedef struct {
+    int msg_type;            // MSG_ASYNC_JOB
+    uint32_t job_id;
+    uint32_t work_us;        // Simulated processing time
+    struct sigevent event;   // Delivered by the server when the job completes
+} AsyncJobMsg;
+
+// ----- Shared-memory bulk transfer -----
+
+#define SHM_NAME_MAX 64
+#define SHM_REGION_MAGIC 0x51495043u  // "QIPC"
+
+// Lives at offset 0 of every region; payloads follow at SHM_PAYLOAD_OFFSET
+typedef struct {
+    uint32_t magic;
+    uint32_t generation;           // Seqlock: odd while the client writes, even once a frame is complete
+    uint64_t size;                 // Total region size in bytes, header included
+} ShmRegionHeader;
+
+#define SHM_PAYLOAD_OFFSET 64  // Keeps payloads cache-line aligned
+
+typedef struct {
+    int msg_type;              // MSG_SHM_ATTACH
+    char name[SHM_NAME_MAX];   // shm_open() name, must start with '/'
+    uint64_t size;
+} ShmAttachMsg;
+
+typedef struct {
+    int region_id;             // Handle for subsequent ShmFrameMsg / ShmDetachMsg
+} ShmAttachReply;
+
+typedef struct {
+    int msg_type;              // MSG_SHM_FRAME
+    int region_id;
+    uint64_t offset;           // From the start of the region
+    uint64_t length;
+    uint32_t generation;       // Must still match the region header when the server is done
+} ShmFrameMsg;
+
+typedef struct {
+    uint32_t generation;
+    uint32_t checksum;         // Proof the server saw the bytes
+} ShmFrameReply;
+
+typedef struct {
+    int msg_type;              // MSG_SHM_DETACH
+    int region_id;
+} ShmDetachMsg;
+
+// Simple rolling checksum used by both sides to verify a frame
+static inline uint32_t payload_checksum(const unsigned char* data, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum = sum * 31 + data[i];
+    }
+    return sum;
+}
+
+// ----- Client-side shared-memory helpers -----
+
+typedef struct {
+    char name[SHM_NAME_MAX];
+    size_t size;               // Whole region, header included
+    ShmRegionHeader* header;
+    unsigned char* payload;    // SHM_PAYLOAD_OFFSET bytes into the region
+    int region_id;             // Assigned by the server on attach
+} ShmClientRegion;
+
+// Creates a region with room for payload_bytes and attaches it to the server. Returns 0 or -1.
+// instance keeps the names unique when one process attaches several regions.
+static inline int ipc_shm_attach(int coid, size_t payload_bytes, unsigned instance, ShmClientRegion* region) {
+    ShmAttachMsg attach;
+    attach.msg_type = MSG_SHM_ATTACH;
+    snprintf(attach.name, sizeof(attach.name), "/qnx_ipc_%d_%u", getpid(), instance);
+    attach.size = SHM_PAYLOAD_OFFSET + payload_bytes;
+
+    int fd = shm_open(attach.name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1) {
+        perror("shm_open failed");
+        return -1;
+    }
+    if (ftruncate(fd, attach.size) == -1) {
+        perror("ftruncate failed");
+        close(fd);
+        shm_unlink(attach.name);
+        return -1;
+    }
+    void* base = mmap(NULL, attach.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("mmap failed");
+        shm_unlink(attach.name);
+        return -1;
+    }
+
+    ShmRegionHeader* header = (ShmRegionHeader*)base;
+    header->magic = SHM_REGION_MAGIC;
+    header->generation = 0;
+    header->size = attach.size;
+
+    ShmAttachReply attached;
+    if (MsgSend(coid, &attach, sizeof(attach), &attached, sizeof(attached)) == -1) {
+        perror("MsgSend(MSG_SHM_ATTACH) failed");
+        munmap(base, attach.size);
+        shm_unlink(attach.name);
+        return -1;
+    }
+
+    memcpy(region->name, attach.name, sizeof(region->name));
+    region->size = attach.size;
+    region->header = header;
+    region->payload = (unsigned char*)base + SHM_PAYLOAD_OFFSET;
+    region->region_id = attached.region_id;
+    return 0;
+}
+
+// Call before writing a frame into region->payload: a server still reading the previous frame sees
+// an odd generation and rejects it instead of returning a checksum of half-written bytes
+static inline void ipc_shm_begin_frame(ShmClientRegion* region) {
+    uint32_t generation = __atomic_load_n(&region->header->generation, __ATOMIC_RELAXED);
+    __atomic_store_n(&region->header->generation, generation | 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);  // The odd value is visible before any payload byte changes
+}
+
+// Publishes the len bytes already written to region->payload and waits for the server. Returns 0 or -1.
+// Resending an unchanged frame without ipc_shm_begin_frame() is fine; rewriting one without it is not detected.
+static inline int ipc_shm_send_frame(int coid, ShmClientRegion* region, size_t len, ShmFrameReply* reply) {
+    uint32_t generation = (__atomic_load_n(&region->header->generation, __ATOMIC_RELAXED) | 1) + 1;
+    __atomic_store_n(&region->header->generation, generation, __ATOMIC_RELEASE);  // Frame complete
+
+    ShmFrameMsg desc;
+    desc.msg_type = MSG_SHM_FRAME;
+    desc.region_id = region->region_id;
+    desc.offset = SHM_PAYLOAD_OFFSET;
+    desc.length = len;
+    desc.generation = generation;
+    return MsgSend(coid, &desc, sizeof(desc), reply, sizeof(*reply)) == -1 ? -1 : 0;
+}
+
+static inline void ipc_shm_detach(int coid, ShmClientRegion* region) {
+    ShmDetachMsg detach;
+    detach.msg_type = MSG_SHM_DETACH;
+    detach.region_id = region->region_id;
+    MsgSend(coid, &detach, sizeof(detach), NULL, 0);
+    munmap(region->header, region->size);
+    shm_unlink(region->name);
+}
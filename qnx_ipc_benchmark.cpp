@@ -0,0 +1,278 @@
+/*QNX IPC Benchmark - Round-Trip Latency and Throughput for QNX_ipc.cpp
+Sends millions of messages to the server from QNX_ipc.cpp and reports, per configuration:
+messages/sec and p50 / p99 / p99.9 / max round-trip latency measured with ClockCycles().
+
+Modes (-m):
+fixed  - original fixed-size Message through MsgSend() (payload size ignored, always 104 bytes)
+record - MsgHeader + payload through MsgSendv() (server pulls > 512 bytes with MsgRead())
+shm    - payload written to shared memory, ShmFrameMsg descriptor through MsgSend()
+pulse  - one-way MsgSendPulse(); latency is the send cost only, there is no reply
+
+Each configuration is run for every combination of -s payload sizes, -c client counts and -P priorities.
+Clients are threads with their own connection; each -P entry runs them at that SCHED_FIFO priority
+(0: inherit the benchmark's own policy and priority), so -P 10,30,60 shows how latency varies with it.
+Connecting, attaching shared memory and the warm-up messages happen before the clients meet at a barrier;
+msgs/s covers only the measured messages, from the first client's start to the last client's finish.
+Start the server with -q so it does not printf() every message.
+Usage: ./qnx_ipc_benchmark [-m fixed,record,shm,pulse] [-s 16,256,4096,65536] [-c 1,4]
+                           [-n messages_per_client] [-P 0,10,30] [-a server_name]*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/neutrino.h>
+#include <sys/netmgr.h>
+#include <sys/syspage.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "qnx_ipc.h"
+
+#define WARMUP_MESSAGES 1000
+
+enum BenchMode { MODE_FIXED, MODE_RECORD, MODE_SHM, MODE_PULSE };
+
+static const char* const mode_names[] = { "fixed", "record", "shm", "pulse" };
+
+typedef struct {
+    BenchMode mode;
+    size_t payload;
+    long messages;
+    const char* server_name;
+    unsigned index;                 // Client number, keeps shm names unique
+    std::vector<uint64_t>* cycles;  // One round-trip time per message
+    pthread_barrier_t* start_line;  // Every client, set up and warmed up, waits here before measuring
+    struct timespec start, end;     // Measured messages only
+    int failed;
+} ClientRun;
+
+// One message in the selected mode; returns -1 on failure
+static int send_one(const ClientRun* run, int coid, Message* fixed, unsigned char* payload,
+                    ShmClientRegion* region, char* reply, uint32_t reply_cap) {
+    switch (run->mode) {
+    case MODE_FIXED: {
+        Message fixed_reply;
+        return MsgSend(coid, fixed, sizeof(*fixed), &fixed_reply, sizeof(fixed_reply)) == -1 ? -1 : 0;
+    }
+    case MODE_RECORD:
+        return ipc_send_record(coid, MSG_RECORD, payload, (uint32_t)run->payload, reply, reply_cap) == -1 ? -1 : 0;
+    case MODE_SHM: {
+        ShmFrameReply frame_reply;
+        return ipc_shm_send_frame(coid, region, run->payload, &frame_reply);
+    }
+    case MODE_PULSE:
+        return MsgSendPulse(coid, -1, PULSE_CODE_TELEMETRY, 1);
+    }
+    return -1;
+}
+
+static void* client_thread(void* arg) {
+    ClientRun* run = (ClientRun*)arg;
+    run->failed = 1;
+
+    // Each client gets its own connection (not the shared cache) so clients do not share a coid
+    IpcConnection conn;
+    ipc_connection_init(&conn, run->server_name);
+    int coid = ipc_connection_coid(&conn);
+    int ok = coid != -1;
+    if (!ok) {
+        perror("name_open failed");
+    }
+
+    Message fixed;
+    fixed.msg_type = MSG_TEXT;
+    strcpy(fixed.text, "Hello, Server!");
+    std::vector<unsigned char> payload(run->payload ? run->payload : 1, 0x5a);
+    char reply[128];
+    ShmClientRegion region;
+    int attached = 0;
+    if (ok && run->mode == MODE_SHM) {
+        attached = ok = ipc_shm_attach(coid, run->payload, run->index, &region) == 0;
+        if (attached) memset(region.payload, 0x5a, run->payload);
+    }
+
+    for (long i = 0; i < WARMUP_MESSAGES && ok; i++) {
+        ok = send_one(run, coid, &fixed, payload.data(), &region, reply, sizeof(reply)) == 0;
+    }
+    pthread_barrier_wait(run->start_line);  // Also on failure, or the other clients would wait forever
+
+    clock_gettime(CLOCK_MONOTONIC, &run->start);
+    for (long i = 0; i < run->messages && ok; i++) {
+        uint64_t start = ClockCycles();
+        ok = send_one(run, coid, &fixed, payload.data(), &region, reply, sizeof(reply)) == 0;
+        (*run->cycles)[i] = ClockCycles() - start;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &run->end);
+    if (!ok && coid != -1 && (run->mode != MODE_SHM || attached)) {  // Other failures were reported above
+        perror("send failed");
+    }
+
+    if (attached) {
+        ipc_shm_detach(coid, &region);
+    }
+    if (coid != -1) {
+        ipc_connection_close(&conn);
+    }
+    run->failed = !ok;
+    return NULL;
+}
+
+static double seconds_between(const struct timespec& from, const struct timespec& to) {
+    return (to.tv_sec - from.tv_sec) + (to.tv_nsec - from.tv_nsec) / 1e9;
+}
+
+static void run_config(BenchMode mode, size_t payload, int clients, int priority, long messages,
+                       const char* server_name) {
+    std::vector<std::vector<uint64_t> > cycles(clients, std::vector<uint64_t>(messages));
+    std::vector<ClientRun> runs(clients);
+    std::vector<pthread_t> tids(clients);
+    pthread_barrier_t start_line;
+    pthread_barrier_init(&start_line, NULL, (unsigned)clients);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (priority > 0) {
+        struct sched_param param;
+        param.sched_priority = priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    for (int i = 0; i < clients; i++) {
+        runs[i].mode = mode;
+        runs[i].payload = payload;
+        runs[i].messages = messages;
+        runs[i].server_name = server_name;
+        runs[i].index = (unsigned)i;
+        runs[i].cycles = &cycles[i];
+        runs[i].start_line = &start_line;
+        int err = pthread_create(&tids[i], &attr, client_thread, &runs[i]);
+        if (err != 0) {
+            fprintf(stderr, "pthread_create failed: %s\n", strerror(err));
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < clients; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    pthread_attr_destroy(&attr);
+    pthread_barrier_destroy(&start_line);
+
+    std::vector<uint64_t> all;
+    all.reserve((size_t)clients * messages);
+    struct timespec first_start = runs[0].start, last_end = runs[0].end;
+    for (int i = 0; i < clients; i++) {
+        if (runs[i].failed) {
+            printf("%-7s %9zu %7d %4d  client %d failed\n", mode_names[mode], payload, clients, priority, i);
+            return;
+        }
+        all.insert(all.end(), cycles[i].begin(), cycles[i].end());
+        if (seconds_between(runs[i].start, first_start) > 0) first_start = runs[i].start;
+        if (seconds_between(last_end, runs[i].end) > 0) last_end = runs[i].end;
+    }
+    std::sort(all.begin(), all.end());
+
+    double seconds = seconds_between(first_start, last_end);
+    double us_per_cycle = 1e6 / (double)SYSPAGE_ENTRY(qtime)->cycles_per_sec;
+    size_t n = all.size();
+    printf("%-7s %9zu %7d %4d %12.0f %9.2f %9.2f %9.2f %9.2f\n",
+           mode_names[mode], payload, clients, priority, n / seconds,
+           all[n * 50 / 100] * us_per_cycle, all[n * 99 / 100] * us_per_cycle,
+           all[n * 999 / 1000] * us_per_cycle, all[n - 1] * us_per_cycle);
+}
+
+// Parses "a,b,c" into numbers
+static std::vector<long> parse_list(const char* text) {
+    std::vector<long> values;
+    std::string item;
+    for (const char* p = text;; p++) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) values.push_back(strtol(item.c_str(), NULL, 0));
+            item.clear();
+            if (*p == '\0') break;
+        } else {
+            item += *p;
+        }
+    }
+    return values;
+}
+
+static std::vector<BenchMode> parse_modes(const char* text) {
+    std::vector<BenchMode> modes;
+    std::string list = std::string(text) + ",";
+    size_t pos;
+    while ((pos = list.find(',')) != std::string::npos) {
+        std::string name = list.substr(0, pos);
+        list.erase(0, pos + 1);
+        for (int m = MODE_FIXED; m <= MODE_PULSE; m++) {
+            if (name == mode_names[m]) modes.push_back((BenchMode)m);
+        }
+    }
+    return modes;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<BenchMode> modes = parse_modes("fixed,record,shm,pulse");
+    std::vector<long> sizes = parse_list("16,256,4096,65536");
+    std::vector<long> client_counts = parse_list("1,4");
+    long messages = 1000000;
+    std::vector<long> priorities = parse_list("0");
+    const char* server_name = IPC_SERVER_NAME;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:s:c:n:P:a:")) != -1) {
+        switch (opt) {
+        case 'm': modes = parse_modes(optarg); break;
+        case 's': sizes = parse_list(optarg); break;
+        case 'c': client_counts = parse_list(optarg); break;
+        case 'n': messages = strtol(optarg, NULL, 0); break;
+        case 'P': priorities = parse_list(optarg); break;
+        case 'a': server_name = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-m modes] [-s sizes] [-c clients] [-n messages] [-P priorities] "
+                            "[-a server_name]\n", argv[0]);
+            return -1;
+        }
+    }
+    if (messages < 1 || modes.empty() || sizes.empty() || client_counts.empty() || priorities.empty()) {
+        fprintf(stderr, "Nothing to run\n");
+        return -1;
+    }
+
+    printf("%-7s %9s %7s %4s %12s %9s %9s %9s %9s\n",
+           "mode", "payload", "clients", "prio", "msgs/s", "p50(us)", "p99(us)", "p99.9(us)", "max(us)");
+    for (BenchMode mode : modes) {
+        for (long priority : priorities) {
+            if (mode == MODE_FIXED || mode == MODE_PULSE) {
+                // Payload size does not apply: Message is always sizeof(Message), a pulse carries 4 bytes
+                for (long clients : client_counts) {
+                    run_config(mode, mode == MODE_FIXED ? sizeof(Message) : 0, (int)clients, (int)priority,
+                               messages, server_name);
+                }
+                continue;
+            }
+            for (long size : sizes) {
+                for (long clients : client_counts) {
+                    run_config(mode, (size_t)size, (int)clients, (int)priority, messages, server_name);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/*Interpreting the results
+fixed vs record at small sizes shows the cost of the padded 104-byte struct.
+record vs shm at large sizes shows where copying through the kernel starts to dominate.
+pulse shows the one-way cost a telemetry producer pays per update.
+Across -P priorities, p50 should barely move on an idle system; the p99.9 and max columns show how well
+a higher priority shields the clients from other load (run something busy next to the benchmark).
+Run the same command before and after a BSP update to catch regressions.*/
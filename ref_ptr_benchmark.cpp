@@ -0,0 +1,107 @@
+/*Reference-Counted Pointer Microbenchmark: shared_ptr vs local_ref_ptr vs atomic_ref_ptr
+Measures, in ns/op on one thread:
+1. copy   - assigning a pointer into a slot of a ring of pointers (one increment, and one decrement
+            of the pointer it replaces), the pattern of an object graph being rewired.
+2. create - allocating, constructing and releasing an object (make_shared / make_local_ref / make_atomic_ref).
+3. lock   - weak_ptr::lock() plus the release of the locked pointer (shared_ptr only; the intrusive
+            pointers have no weak form, the comparable cost is their copy).
+Also prints the pointer sizes: shared_ptr carries a second word for its control block.
+Usage: ./ref_ptr_benchmark [iterations]*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "local_ref_ptr.hpp"
+
+volatile long benchmarkSink;  // Keeps the measured work from being optimized away
+
+struct SharedNode {
+    long value = 1;
+};
+struct LocalNode : LocalRefCounted {
+    long value = 1;
+};
+struct AtomicNode : AtomicRefCounted {
+    long value = 1;
+};
+
+template <typename Fn>
+double nanosPerOp(long iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// Alternates between two objects so every assignment really changes the slot's owner
+template <typename Ptr>
+double copyCost(const Ptr& first, const Ptr& second, long iterations) {
+    std::vector<Ptr> slots(1024);
+    double ns = nanosPerOp(iterations, [&](long i) { slots[i & 1023] = (i & 1024) ? second : first; });
+    long sum = 0;
+    for (const auto& slot : slots) sum += slot->value;
+    benchmarkSink = sum;
+    return ns;
+}
+
+// Each new object replaces an old one in the ring, so every op is one allocation and one free
+template <typename Make>
+double createCost(long iterations, Make&& make) {
+    std::vector<decltype(make())> slots(1024);
+    double ns = nanosPerOp(iterations, [&](long i) { slots[i & 1023] = make(); });
+    long sum = 0;
+    for (const auto& slot : slots) sum += slot->value;
+    benchmarkSink = sum;
+    return ns;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 20'000'000;
+    // libstdc++ uses non-atomic shared_ptr counts until the process starts its first thread;
+    // real programs have threads, so measure the atomic path
+    std::thread([] {}).join();
+
+    auto shared = std::make_shared<SharedNode>();
+    auto local = make_local_ref<LocalNode>();
+    auto atomic = make_atomic_ref<AtomicNode>();
+    std::weak_ptr<SharedNode> weak = shared;
+
+    double copyShared = copyCost(shared, std::make_shared<SharedNode>(), iterations);
+    double copyLocal = copyCost(local, make_local_ref<LocalNode>(), iterations);
+    double copyAtomic = copyCost(atomic, make_atomic_ref<AtomicNode>(), iterations);
+
+    long createIterations = iterations / 4;
+    double createShared = createCost(createIterations, [] { return std::make_shared<SharedNode>(); });
+    double createLocal = createCost(createIterations, [] { return make_local_ref<LocalNode>(); });
+    double createAtomic = createCost(createIterations, [] { return make_atomic_ref<AtomicNode>(); });
+
+    long sum = 0;
+    double lockShared = nanosPerOp(iterations, [&](long) { sum += weak.lock()->value; });
+    benchmarkSink = sum;
+
+    std::cout << std::left << std::setw(16) << "pointer" << std::right << std::setw(8) << "bytes" << std::setw(12)
+              << "copy ns" << std::setw(12) << "create ns" << std::setw(12) << "lock ns" << "\n"
+              << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(16) << "shared_ptr" << std::right << std::setw(8) << sizeof(shared)
+              << std::setw(12) << copyShared << std::setw(12) << createShared << std::setw(12) << lockShared << "\n";
+    std::cout << std::left << std::setw(16) << "local_ref_ptr" << std::right << std::setw(8) << sizeof(local)
+              << std::setw(12) << copyLocal << std::setw(12) << createLocal << std::setw(12) << "-" << "\n";
+    std::cout << std::left << std::setw(16) << "atomic_ref_ptr" << std::right << std::setw(8) << sizeof(atomic)
+              << std::setw(12) << copyAtomic << std::setw(12) << createAtomic << std::setw(12) << "-" << "\n";
+}
+
+/*Interpreting the results
+copy: shared_ptr and atomic_ref_ptr both pay a locked increment and decrement; local_ref_ptr pays
+two plain memory operations, which is where most of the hot-path saving comes from.
+create: all three allocate once here (make_shared co-allocates the control block); the intrusive
+objects are smaller, and there is no control block to initialize.
+lock: weak_ptr::lock() is a compare-exchange loop on the use count; if a hot path locks weak
+pointers, consider whether it can hold a strong local_ref_ptr instead.
+Note: libstdc++ keeps shared_ptr counts non-atomic while a process has only one thread,
+which is why main() starts and joins a thread before measuring.*/
@@ -0,0 +1,205 @@
+/*RegisterBlock<Layout> - Typed, Compile-Time-Checked Access to a Memory-Mapped Register Block
+A driver does not talk to one volatile int; it maps a device's register block once and reads and
+writes fields inside it. Done by hand (*(volatile uint32_t*)(base + 0x14) & 0x38) >> 3 everywhere,
+offsets and masks drift from the datasheet, and every field access becomes another volatile read,
+even when five fields of the same status register are needed in one ISR.
+
+A Layout describes the block at compile time: its size plus one RegField per field
+(word type, byte offset, bit position, width, access). RegisterBlock<Layout> maps the physical range
+once (mmap_device_memory() on QNX, mmap() of /dev/mem elsewhere) and offers:
+read<F>()             - one volatile read of the register containing F, then shift and mask
+write<F>(v)           - a plain store if F covers its whole register, read-modify-write only if not
+write<F, G...>(v...)  - several fields of the same register in a single read-modify-write
+snapshot<W, Off, N>() - N consecutive registers copied in one pass (each read exactly once);
+                        fields are then decoded from the copy with get<F>() at no bus cost.
+Out-of-range offsets, misaligned registers, fields wider than their register, writes to read-only
+and reads of write-only fields are compile errors, not bus faults.*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+enum class RegAccess { ReadOnly, WriteOnly, ReadWrite };
+
+template <typename Word, std::size_t Offset, unsigned Shift = 0, unsigned Width = sizeof(Word) * 8,
+          RegAccess Access = RegAccess::ReadWrite>
+struct RegField {
+    static_assert(std::is_unsigned_v<Word>, "Registers are unsigned words");
+    static_assert(Offset % sizeof(Word) == 0, "Register offset must be aligned to its width");
+    static_assert(Width > 0 && Shift + Width <= sizeof(Word) * 8, "Field does not fit in its register");
+
+    using word_type = Word;
+    static constexpr std::size_t offset = Offset;
+    static constexpr unsigned shift = Shift;
+    static constexpr unsigned width = Width;
+    static constexpr RegAccess access = Access;
+    static constexpr bool wholeWord = Width == sizeof(Word) * 8;
+    static constexpr Word mask =
+        wholeWord ? static_cast<Word>(~Word(0)) : static_cast<Word>(((Word(1) << Width) - 1) << Shift);
+
+    static constexpr Word decode(Word raw) { return static_cast<Word>((raw & mask) >> Shift); }
+    static constexpr Word encode(Word value) { return static_cast<Word>((value << Shift) & mask); }
+};
+
+// Copy of N consecutive Word registers starting at Offset, taken in one pass
+template <typename Word, std::size_t Offset, std::size_t N>
+class RegisterSnapshot {
+public:
+    template <typename Field>
+    Word get() const {
+        static_assert(std::is_same_v<typename Field::word_type, Word>, "Field width differs from the snapshot's");
+        static_assert(Field::offset >= Offset && Field::offset < Offset + N * sizeof(Word),
+                      "Field is outside the snapshot");
+        static_assert(Field::access != RegAccess::WriteOnly, "Field is write-only");
+        return Field::decode(words[(Field::offset - Offset) / sizeof(Word)]);
+    }
+
+    std::array<Word, N> words;
+};
+
+template <typename Layout>
+class RegisterBlock {
+public:
+    // Maps Layout::kSize bytes of physical address space (uncached). Check error() before use.
+    explicit RegisterBlock(std::uint64_t physical) {
+#ifdef __QNX__
+        void* p = mmap_device_memory(nullptr, Layout::kSize, PROT_READ | PROT_WRITE | PROT_NOCACHE, 0, physical);
+        if (p == MAP_FAILED) {
+            error_ = errno;
+            return;
+        }
+        mapping_ = p;
+        mappedBytes_ = Layout::kSize;
+        base_ = static_cast<volatile unsigned char*>(p);
+#else
+        int fd = open("/dev/mem", O_RDWR | O_SYNC);
+        if (fd == -1) {
+            error_ = errno;
+            return;
+        }
+        // mmap() needs a page-aligned offset; map from the page start and keep the remainder
+        std::uint64_t page = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+        std::uint64_t start = physical & ~(page - 1);
+        std::size_t lead = static_cast<std::size_t>(physical - start);
+        void* p = mmap(nullptr, lead + Layout::kSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                       static_cast<off_t>(start));
+        error_ = p == MAP_FAILED ? errno : 0;
+        close(fd);
+        if (p == MAP_FAILED) return;
+        mapping_ = p;
+        mappedBytes_ = lead + Layout::kSize;
+        base_ = static_cast<volatile unsigned char*>(p) + lead;
+#endif
+    }
+
+    // Uses memory that is already mapped (shared memory, a simulated device); nothing is unmapped
+    static RegisterBlock attach(void* base) { return RegisterBlock(static_cast<volatile unsigned char*>(base)); }
+
+    RegisterBlock(RegisterBlock&& other) noexcept
+        : base_(other.base_), mapping_(other.mapping_), mappedBytes_(other.mappedBytes_), error_(other.error_) {
+        other.mapping_ = nullptr;
+        other.base_ = nullptr;
+    }
+    RegisterBlock(const RegisterBlock&) = delete;
+    RegisterBlock& operator=(const RegisterBlock&) = delete;
+
+    ~RegisterBlock() {
+        if (mapping_) {
+#ifdef __QNX__
+            munmap_device_memory(mapping_, mappedBytes_);
+#else
+            munmap(mapping_, mappedBytes_);
+#endif
+        }
+    }
+
+    int error() const { return error_; }  // errno from mapping, 0 if usable
+
+    template <typename Field>
+    typename Field::word_type read() const {
+        static_assert(Field::access != RegAccess::WriteOnly, "Field is write-only");
+        return Field::decode(load<Field>());
+    }
+
+    // One field: plain store when it owns the whole register (no read needed)
+    template <typename Field>
+    void write(typename Field::word_type value) {
+        static_assert(Field::access != RegAccess::ReadOnly, "Field is read-only");
+        if constexpr (Field::wholeWord) {
+            store<Field>(value);
+        } else {
+            static_assert(Field::access == RegAccess::ReadWrite, "Partial write needs a readable register");
+            using Word = typename Field::word_type;
+            store<Field>(static_cast<Word>((load<Field>() & ~Field::mask) | Field::encode(value)));
+        }
+    }
+
+    // Several fields of the same register, one read-modify-write
+    template <typename First, typename Second, typename... Rest, typename... Values>
+    void write(Values... values) {
+        using Word = typename First::word_type;
+        static_assert(sizeof...(Values) == 2 + sizeof...(Rest), "One value per field");
+        static_assert(((Rest::offset == First::offset) && ... && (Second::offset == First::offset)),
+                      "Fields must share one register");
+        static_assert(((Rest::access == RegAccess::ReadWrite) && ... &&
+                       (First::access == RegAccess::ReadWrite && Second::access == RegAccess::ReadWrite)),
+                      "Read-modify-write needs read-write fields");
+        constexpr Word mask = static_cast<Word>((Rest::mask | ... | (First::mask | Second::mask)));
+        Word value = encodeFields<First, Second, Rest...>(values...);
+        store<First>(static_cast<Word>((load<First>() & ~mask) | value));
+    }
+
+    // Reads N registers of type Word starting at Offset, each exactly once, in address order
+    template <typename Word, std::size_t Offset, std::size_t N>
+    RegisterSnapshot<Word, Offset, N> snapshot() const {
+        static_assert(Offset % sizeof(Word) == 0, "Snapshot must start on a register boundary");
+        static_assert(Offset + N * sizeof(Word) <= Layout::kSize, "Snapshot runs past the register block");
+        RegisterSnapshot<Word, Offset, N> copy;
+        const volatile Word* regs = reinterpret_cast<const volatile Word*>(base_ + Offset);
+        for (std::size_t i = 0; i < N; ++i) {
+            copy.words[i] = regs[i];
+        }
+        return copy;
+    }
+
+private:
+    explicit RegisterBlock(volatile unsigned char* base) : base_(base) {}
+
+    template <typename Field>
+    static constexpr void checkInBlock() {
+        static_assert(Field::offset + sizeof(typename Field::word_type) <= Layout::kSize,
+                      "Field is outside the register block");
+    }
+
+    template <typename Field>
+    typename Field::word_type load() const {
+        checkInBlock<Field>();
+        return *reinterpret_cast<const volatile typename Field::word_type*>(base_ + Field::offset);
+    }
+
+    template <typename Field>
+    void store(typename Field::word_type raw) {
+        checkInBlock<Field>();
+        *reinterpret_cast<volatile typename Field::word_type*>(base_ + Field::offset) = raw;
+    }
+
+    // Pairs each field with its value; the fields share one word type
+    template <typename... Fields, typename... Values>
+    static auto encodeFields(Values... values) {
+        using Word = std::common_type_t<typename Fields::word_type...>;
+        return static_cast<Word>((Fields::encode(static_cast<Word>(values)) | ...));
+    }
+
+    volatile unsigned char* base_ = nullptr;
+    void* mapping_ = nullptr;  // Owned mapping, nullptr for attach()
+    std::size_t mappedBytes_ = 0;
+    int error_ = 0;
+};
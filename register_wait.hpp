@@ -0,0 +1,148 @@
+/*wait_until - Waiting on a Hardware Status Register without Burning a Core
+while (reg != READY) {} keeps one core at 100% for as long as the device takes, and printing inside
+the loop makes it worse. Most waits are either very short (the device is nearly done) or long
+(it needs milliseconds), so wait_until() escalates through cheaper and cheaper tiers:
+1. spin     - re-read the register with a CPU pause hint (_mm_pause / ARM yield) between reads;
+              the fastest reaction, for waits of a few microseconds.
+2. backoff  - yield, then sleep for exponentially growing intervals (minBackoff .. maxBackoff),
+              for up to backoffBudget; the core is free for other work between polls.
+3. block    - wait for an event instead of polling, e.g. the device's interrupt
+              (InterruptEvent: InterruptAttachEvent + InterruptWait on QNX). Without an event the
+              wait keeps polling at maxBackoff.
+The register is re-read after every tier step, so a missed or shared interrupt only costs one
+timeout. The result reports how long the wait took, how many reads it needed and which tier ended it.*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef __QNX__
+#include <errno.h>
+#include <sys/neutrino.h>
+#endif
+
+enum class WaitTier { Spin, Backoff, Block, Timeout };
+
+struct WaitResult {
+    bool satisfied;                  // false: timed out
+    WaitTier tier;                   // Tier the wait ended in
+    std::chrono::nanoseconds waited;
+    std::uint64_t polls;             // Register reads
+};
+
+struct WaitPolicy {
+    std::uint32_t spins = 2000;
+    std::chrono::nanoseconds minBackoff = std::chrono::microseconds(1);
+    std::chrono::nanoseconds maxBackoff = std::chrono::milliseconds(1);
+    std::chrono::nanoseconds backoffBudget = std::chrono::milliseconds(5);
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0);  // 0 = wait forever
+    // Tier 3: blocks until the event fires or the given time passes (e.g. InterruptEvent::wait)
+    std::function<void(std::chrono::nanoseconds)> block;
+};
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+template <typename T, typename Predicate>
+WaitResult wait_until(const volatile T& reg, Predicate pred, const WaitPolicy& policy = WaitPolicy()) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    std::uint64_t polls = 0;
+    auto done = [&](WaitTier tier, bool satisfied) {
+        return WaitResult{satisfied, tier, Clock::now() - start, polls};
+    };
+    auto ready = [&] {
+        ++polls;
+        return pred(static_cast<T>(reg));  // One volatile read per check
+    };
+    auto expired = [&](Clock::time_point now) {
+        return policy.timeout.count() > 0 && now - start >= policy.timeout;
+    };
+
+    for (std::uint32_t i = 0; i < policy.spins; ++i) {
+        if (ready()) return done(WaitTier::Spin, true);
+        cpuRelax();
+    }
+
+    std::chrono::nanoseconds backoff = policy.minBackoff;
+    const Clock::time_point backoffEnd = Clock::now() + policy.backoffBudget;
+    std::this_thread::yield();
+    for (;;) {
+        if (ready()) return done(WaitTier::Backoff, true);
+        Clock::time_point now = Clock::now();
+        if (expired(now)) return done(WaitTier::Timeout, false);
+        if (now >= backoffEnd) break;
+        std::this_thread::sleep_for(backoff);
+        if (backoff < policy.maxBackoff) backoff = backoff * 2 < policy.maxBackoff ? backoff * 2 : policy.maxBackoff;
+    }
+
+    for (;;) {
+        if (ready()) return done(WaitTier::Block, true);
+        Clock::time_point now = Clock::now();
+        if (expired(now)) return done(WaitTier::Timeout, false);
+        std::chrono::nanoseconds slice = policy.maxBackoff;
+        if (policy.timeout.count() > 0 && policy.timeout - (now - start) < slice) {
+            slice = policy.timeout - (now - start);
+        }
+        if (policy.block) {
+            policy.block(slice);
+        } else {
+            std::this_thread::sleep_for(slice);
+        }
+    }
+}
+
+#ifdef __QNX__
+// The interrupt a device raises when its status changes, delivered as an event to the waiting thread.
+// The process needs I/O privileges (ThreadCtl(_NTO_TCTL_IO) is called here) to attach interrupts.
+class InterruptEvent {
+public:
+    explicit InterruptEvent(int irq) : irq_(irq) {
+        if (ThreadCtl(_NTO_TCTL_IO, 0) == -1) {
+            error_ = errno;
+            return;
+        }
+        SIGEV_INTR_INIT(&event_);
+        id_ = InterruptAttachEvent(irq, &event_, _NTO_INTR_FLAGS_TRK_MSK);
+        if (id_ == -1) error_ = errno;
+    }
+    InterruptEvent(const InterruptEvent&) = delete;
+    InterruptEvent& operator=(const InterruptEvent&) = delete;
+    ~InterruptEvent() {
+        if (id_ != -1) InterruptDetach(id_);
+    }
+
+    int error() const { return error_; }  // errno from attaching, 0 if usable
+
+    // Blocks until the interrupt fires or the timeout passes, then unmasks it for the next one.
+    // Must be called from the thread that created the InterruptEvent.
+    void wait(std::chrono::nanoseconds timeout) {
+        std::uint64_t ns = static_cast<std::uint64_t>(timeout.count());
+        TimerTimeout(CLOCK_MONOTONIC, _NTO_TIMEOUT_INTR, nullptr, &ns, nullptr);
+        if (InterruptWait(0, nullptr) == 0) {
+            InterruptUnmask(irq_, id_);  // InterruptAttachEvent masked it when it fired
+        }
+    }
+
+private:
+    struct sigevent event_;
+    int irq_;
+    int id_ = -1;
+    int error_ = 0;
+};
+#endif
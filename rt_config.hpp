@@ -0,0 +1,115 @@
+/*Real-Time Thread Setup - Scheduling Policy, Priority, CPU Affinity and Memory Locking
+Most missed deadlines are not caused by the task's own code but by what happens around it:
+a normal-priority thread (or the logger) preempts it, the scheduler migrates it to a cold core,
+or the first touch of a stack or heap page takes a page fault in the middle of a release.
+
+TaskConfig describes how a real-time thread should run; applyTaskConfig() is called on that thread
+before its first release:
+policy/priority - pthread_setschedparam(); SCHED_FIFO or SCHED_RR with a priority above everything
+                  the task must not wait for. SCHED_OTHER leaves the thread as it was created.
+cpu             - pins the thread to one CPU: ThreadCtl(_NTO_TCTL_RUNMASK) on QNX,
+                  pthread_setaffinity_np() on Linux.
+stackPrefault   - touches that many bytes of the thread's stack so the pages exist before the loop.
+lockMemory() is process-wide: mlockall(MCL_CURRENT | MCL_FUTURE) plus a pre-faulted heap reserve,
+so neither existing nor later pages can be paged out or faulted in lazily.
+Every function returns 0 or an errno value, like the pthread calls it wraps.
+Real-time priorities and mlockall() usually need privileges (root, or CAP_SYS_NICE/CAP_IPC_LOCK).*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <alloca.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#ifdef __QNX__
+#include <sys/neutrino.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+struct TaskConfig {
+    int policy = SCHED_OTHER;  // SCHED_FIFO / SCHED_RR for real-time tasks
+    int priority = 0;          // Ignored for SCHED_OTHER
+    int cpu = -1;              // -1: let the scheduler choose
+    std::size_t stackPrefault = 64 * 1024;
+};
+
+// Applies to the calling thread
+inline int setSchedPolicy(int policy, int priority) {
+    if (policy == SCHED_OTHER) return 0;
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), policy, &param);
+}
+
+inline int pinToCpu(int cpu) {
+    if (cpu < 0) return 0;
+#if defined(__QNX__)
+    if (cpu >= 32) return EINVAL;
+    if (ThreadCtl(_NTO_TCTL_RUNMASK, reinterpret_cast<void*>(static_cast<std::uintptr_t>(1u) << cpu)) == -1) {
+        return errno;
+    }
+    return 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    return ENOTSUP;
+#endif
+}
+
+// Touches `bytes` of stack below the caller so those pages are mapped (and locked by MCL_FUTURE)
+__attribute__((noinline)) inline void prefaultStack(std::size_t bytes) {
+    volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+    for (std::size_t i = 0; i < bytes; i += 4096) {
+        stack[i] = 0;
+    }
+}
+
+// Locks all current and future pages and pre-faults heapReserve bytes of heap that free() keeps around
+inline int lockMemory(std::size_t heapReserve = 1024 * 1024) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == -1) {
+        return errno;
+    }
+#ifdef __GLIBC__
+    // Keep freed memory in the heap instead of returning it, so the reserve stays faulted in
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+    if (heapReserve > 0) {
+        unsigned char* reserve = static_cast<unsigned char*>(std::malloc(heapReserve));
+        if (reserve == nullptr) return ENOMEM;
+        for (std::size_t i = 0; i < heapReserve; i += 4096) {
+            reinterpret_cast<volatile unsigned char*>(reserve)[i] = 0;
+        }
+        std::free(reserve);
+    }
+    return 0;
+}
+
+// Runs on the task's own thread. On failure, *failedStep names the step (for reporting).
+inline int applyTaskConfig(const TaskConfig& config, const char** failedStep) {
+    int err = pinToCpu(config.cpu);  // Pin first so the thread never runs at RT priority on the wrong CPU
+    if (err != 0) {
+        *failedStep = "CPU affinity";
+        return err;
+    }
+    err = setSchedPolicy(config.policy, config.priority);
+    if (err != 0) {
+        *failedStep = "scheduling policy";
+        return err;
+    }
+    prefaultStack(config.stackPrefault);
+    return 0;
+}
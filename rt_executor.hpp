@@ -0,0 +1,263 @@
+/*PeriodicExecutor - Drift-Free Periodic Tasks with Jitter, WCET and Deadline-Miss Statistics
+Running a task with "work, then sleep_for(period)" makes every release late by the work time plus the
+wake-up latency, and the error accumulates. Measuring the result in milliseconds hides the jitter that
+decides whether a control loop is stable.
+
+Each registered task gets its own thread that sleeps with clock_nanosleep(TIMER_ABSTIME) until an
+absolute release time, and the next release is always computed as previous release + period, so
+release times never drift no matter how long the task body or the wake-up takes.
+Every release records, in nanoseconds:
+jitter         - actual start minus the scheduled release time
+execution time - end minus actual start (the maximum is the observed WCET)
+deadline miss  - the body finished later than release + deadline
+
+Times go into LatencyHistograms (latency_histogram.hpp: fixed size, no allocation on the task thread), so a report can show
+p50/p99 and the exact maximum without storing every sample.
+Register all tasks before run(); the statistics are safe to read once run() has returned.
+A task can carry a TaskConfig (rt_config.hpp): its thread applies the policy, priority and CPU affinity
+and pre-faults its stack before the first release. Call lockMemory() once before run().
+
+Overruns are caught while they happen: an OverrunWatchdog timer (rt_watchdog.hpp) fires at
+release + deadline if the body is still running. What happens next is the task's OverrunPolicy:
+Continue        - only count it
+SkipNextRelease - drop the following release so the task gets back onto its schedule
+Fallback        - run the task's cheaper fallback routine instead of the body on the next release
+Escalate        - call the supervisor immediately, from the watchdog thread, while the task overruns
+A body that can stop early may poll task.overrunning() and return a safe result.*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <time.h>
+
+#include "latency_histogram.hpp"
+#include "rt_config.hpp"
+#include "rt_watchdog.hpp"
+
+namespace rt_detail {
+
+inline std::int64_t toNs(const timespec& ts) {
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+inline timespec fromNs(std::int64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    return ts;
+}
+
+inline std::int64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return toNs(ts);
+}
+
+// Sleeps until an absolute CLOCK_MONOTONIC time; restarts after signals instead of returning early
+inline void sleepUntil(std::int64_t ns) {
+    timespec ts = fromNs(ns);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+}  // namespace rt_detail
+
+struct TaskStats {
+    std::uint64_t releases = 0;
+    std::uint64_t deadlineMisses = 0;
+    LatencyHistogram jitter;     // Start minus scheduled release
+    LatencyHistogram execution;  // End minus start; max() is the observed WCET
+    std::atomic<std::uint64_t> overruns{0};  // Watchdog fired while the body was running
+    std::uint64_t skippedReleases = 0;
+    std::uint64_t fallbackRuns = 0;
+};
+
+enum class OverrunPolicy { Continue, SkipNextRelease, Fallback, Escalate };
+
+class PeriodicExecutor {
+public:
+    struct Task {
+        std::string name;
+        std::chrono::nanoseconds period;
+        std::chrono::nanoseconds deadline;  // Relative to each release
+        std::function<void()> body;
+        TaskConfig config;
+        OverrunPolicy overrunPolicy = OverrunPolicy::Continue;
+        std::function<void()> fallback;  // Degraded routine for OverrunPolicy::Fallback
+        TaskStats stats;
+        int setupError = 0;             // errno from applyTaskConfig(); the task still runs
+        const char* failedStep = nullptr;
+
+        // True while the current release runs past its deadline (call from the body)
+        bool overrunning() const { return overrunRelease_.load(std::memory_order_acquire) == release_; }
+
+    private:
+        friend class PeriodicExecutor;
+        std::uint64_t release_ = 0;                     // Sequence of the current release, task thread only
+        std::atomic<std::uint64_t> overrunRelease_{0};  // Last release the watchdog caught overrunning
+        OverrunWatchdog::Timer* timer_ = nullptr;
+    };
+
+    using Supervisor = std::function<void(const Task&)>;
+
+    // watchdogPriority: priority of overrun handling, should be above every task's (see rt_watchdog.hpp)
+    explicit PeriodicExecutor(int watchdogPriority = 0) : watchdog_(watchdogPriority) {}
+    PeriodicExecutor(const PeriodicExecutor&) = delete;
+    PeriodicExecutor& operator=(const PeriodicExecutor&) = delete;
+
+    // deadline == 0 means an implicit deadline equal to the period
+    Task& addTask(std::string name, std::chrono::nanoseconds period, std::chrono::nanoseconds deadline,
+                  std::function<void()> body, TaskConfig config = TaskConfig()) {
+        tasks_.push_back(std::make_unique<Task>());
+        Task& task = *tasks_.back();
+        task.name = std::move(name);
+        task.period = period;
+        task.deadline = deadline.count() > 0 ? deadline : period;
+        task.body = std::move(body);
+        task.config = config;
+        return task;
+    }
+
+    void setOverrunPolicy(Task& task, OverrunPolicy policy, std::function<void()> fallback = nullptr) {
+        task.overrunPolicy = policy;
+        task.fallback = std::move(fallback);
+    }
+
+    // Called from the watchdog thread for tasks with OverrunPolicy::Escalate
+    void setSupervisor(Supervisor supervisor) { supervisor_ = std::move(supervisor); }
+
+    // Releases every task periodically for the given wall time, then stops and joins the task threads.
+    // All tasks share the same first release so their phases are well defined.
+    void run(std::chrono::nanoseconds duration) {
+        running_.store(true, std::memory_order_relaxed);
+        for (auto& task : tasks_) {
+            if (task->timer_ == nullptr) {
+                Task* watched = task.get();
+                int err = 0;
+                task->timer_ = watchdog_.createTimer([this, watched](std::uint64_t release) {
+                    onOverrun(*watched, release);
+                }, &err);
+                if (task->timer_ == nullptr) {
+                    task->setupError = err;
+                    task->failedStep = "overrun timer";
+                }
+            }
+        }
+        std::int64_t firstRelease = rt_detail::nowNs() + kStartDelayNs;
+        std::vector<std::thread> threads;
+        threads.reserve(tasks_.size());
+        for (auto& task : tasks_) {
+            threads.emplace_back([this, &task, firstRelease] { taskLoop(*task, firstRelease); });
+        }
+        rt_detail::sleepUntil(firstRelease + duration.count());
+        running_.store(false, std::memory_order_relaxed);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    const std::vector<std::unique_ptr<Task>>& tasks() const { return tasks_; }
+
+    void printReport(std::FILE* out = stdout) const {
+        std::fprintf(out, "%-12s %8s %7s %10s %10s %10s %10s %10s %10s\n", "task", "releases", "misses",
+                     "jit p50", "jit p99", "jit max", "exec p50", "exec p99", "WCET");
+        for (const auto& task : tasks_) {
+            const TaskStats& s = task->stats;
+            std::fprintf(out, "%-12s %8llu %7llu %8.1fus %8.1fus %8.1fus %8.1fus %8.1fus %8.1fus\n",
+                         task->name.c_str(), static_cast<unsigned long long>(s.releases),
+                         static_cast<unsigned long long>(s.deadlineMisses), s.jitter.percentile(50) / 1e3,
+                         s.jitter.percentile(99) / 1e3, s.jitter.max() / 1e3, s.execution.percentile(50) / 1e3,
+                         s.execution.percentile(99) / 1e3, s.execution.max() / 1e3);
+        }
+        for (const auto& task : tasks_) {
+            const TaskStats& s = task->stats;
+            if (s.overruns.load() > 0) {
+                std::fprintf(out, "%s: %llu overrun(s) caught in flight, %llu release(s) skipped, %llu fallback run(s)\n",
+                             task->name.c_str(), static_cast<unsigned long long>(s.overruns.load()),
+                             static_cast<unsigned long long>(s.skippedReleases),
+                             static_cast<unsigned long long>(s.fallbackRuns));
+            }
+        }
+        for (const auto& task : tasks_) {
+            if (task->setupError != 0) {
+                std::fprintf(out, "warning: %s ran without its %s: %s\n", task->name.c_str(), task->failedStep,
+                             std::strerror(task->setupError));
+            }
+        }
+    }
+
+private:
+    static constexpr std::int64_t kStartDelayNs = 10000000;  // Time for every thread to reach its first sleep
+
+    void taskLoop(Task& task, std::int64_t release) {
+        const std::int64_t period = task.period.count();
+        const std::int64_t deadline = task.deadline.count();
+        const char* failedStep = nullptr;
+        int err = applyTaskConfig(task.config, &failedStep);
+        if (err != 0) {
+            task.setupError = err;
+            task.failedStep = failedStep;
+        }
+        bool degraded = false;
+        while (running_.load(std::memory_order_relaxed)) {
+            rt_detail::sleepUntil(release);
+            std::int64_t start = rt_detail::nowNs();
+            ++task.release_;  // A late expiry of the previous release carries the old sequence and is ignored
+            if (task.timer_) task.timer_->arm(release + deadline, task.release_);
+            if (degraded) {
+                task.fallback();
+            } else {
+                task.body();
+            }
+            if (task.timer_) task.timer_->disarm();
+            std::int64_t end = rt_detail::nowNs();
+
+            TaskStats& s = task.stats;
+            s.fallbackRuns += degraded;
+            degraded = false;
+            s.releases++;
+            s.jitter.record(start - release);
+            s.execution.record(end - start);
+            if (end > release + deadline) {
+                s.deadlineMisses++;
+            }
+            // The policy changes what happens next, after this release has been accounted against its own time
+            if (task.overrunning()) {
+                if (task.overrunPolicy == OverrunPolicy::SkipNextRelease) {
+                    release += period;
+                    s.skippedReleases++;
+                } else if (task.overrunPolicy == OverrunPolicy::Fallback && task.fallback) {
+                    degraded = true;
+                }
+            }
+            release += period;  // Absolute: lateness in this release does not shift the next one
+        }
+    }
+
+    // Watchdog thread: the body of `task` is still running at the deadline of release `release`
+    void onOverrun(Task& task, std::uint64_t release) {
+        task.overrunRelease_.store(release, std::memory_order_release);
+        task.stats.overruns.fetch_add(1, std::memory_order_relaxed);
+        if (task.overrunPolicy == OverrunPolicy::Escalate && supervisor_) {
+            supervisor_(task);
+        }
+    }
+
+    std::vector<std::unique_ptr<Task>> tasks_;
+    Supervisor supervisor_;
+    OverrunWatchdog watchdog_;  // Declared after tasks_: its timers are deleted before the tasks
+    std::atomic<bool> running_{false};
+};
@@ -0,0 +1,241 @@
+/*OverrunWatchdog - In-Flight Deadline Overrun Detection with POSIX Timers
+Comparing the end time against the deadline after the task returns finds an overrun only once it
+is over; by then the actuator has already waited for a command that was due long ago.
+
+The watchdog gives every task a one-shot timer that is armed at release + deadline when the body
+starts and disarmed when it returns. If the timer fires, the task is still running past its deadline,
+and the watchdog calls the task's expiry handler right then, while the overrun is happening.
+The timers notify one watchdog thread, which runs the handlers:
+QNX:   timer_create() with a SIGEV_PULSE event; the thread blocks in MsgReceivePulse() on a private
+       channel, so a notification costs one pulse and no signal handling.
+Linux: timer_create() with SIGEV_THREAD_ID, which directs a real-time signal at the watchdog thread;
+       the thread keeps it blocked and takes it with sigwaitinfo(), so no signal handler runs.
+       (SIGEV_THREAD is not used: glibc delivers it through a helper thread at normal priority.)
+Give the watchdog a priority above the tasks it watches: a SCHED_FIFO task that overruns keeps
+the CPU, and a lower-priority watchdog would only get to run once the overrun is over.
+Handlers run on the watchdog thread, concurrently with the overrunning task: keep them short and
+only touch state that is safe to share (atomics, a supervisor queue).
+
+The notification only identifies the Timer, and one can be queued just before disarm() and taken after
+the next arm(). So every arm() carries a sequence number (e.g. the release count): an expiry is passed
+to the handler, with that sequence, only if the timer is still armed and its current deadline has passed.
+A handler that stores state for "the current release" should tag it with the sequence it was given.*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __QNX__
+#include <sys/neutrino.h>
+#else
+#include <sys/syscall.h>
+#endif
+
+class OverrunWatchdog {
+public:
+    class Timer;
+
+    // priority: SCHED_FIFO priority of the watchdog thread (QNX: also the pulse priority), 0 = default
+    explicit OverrunWatchdog(int priority = 0) : priority_(priority) {}
+    OverrunWatchdog(const OverrunWatchdog&) = delete;
+    OverrunWatchdog& operator=(const OverrunWatchdog&) = delete;
+
+    ~OverrunWatchdog() {
+        // Stop the thread first: after that a late expiration cannot reach a deleted Timer
+        if (thread_.joinable()) {
+#ifdef __QNX__
+            MsgSendPulse(coid_, SIGEV_PULSE_PRIO_INHERIT, kStopCode, 0);
+#else
+            sigval stop;
+            stop.sival_ptr = nullptr;
+            pthread_sigqueue(thread_.native_handle(), kSignal, stop);
+#endif
+            thread_.join();
+        }
+        timers_.clear();
+#ifdef __QNX__
+        if (coid_ != -1) ConnectDetach(coid_);
+        if (chid_ != -1) ChannelDestroy(chid_);
+#endif
+    }
+
+    // Creates a disarmed timer; onExpire(sequence) runs on the watchdog thread when the arming with that
+    // sequence expires. Returns nullptr and sets *err on failure.
+    Timer* createTimer(std::function<void(std::uint64_t)> onExpire, int* err) {
+        *err = start();
+        if (*err != 0) return nullptr;
+        std::unique_ptr<Timer> timer(new Timer(std::move(onExpire)));
+        sigevent event;
+        memset(&event, 0, sizeof(event));
+#ifdef __QNX__
+        SIGEV_PULSE_PTR_INIT(&event, coid_, priority_ > 0 ? priority_ : SIGEV_PULSE_PRIO_INHERIT, kExpiredCode,
+                             timer.get());
+#else
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = kSignal;
+        event.sigev_value.sival_ptr = timer.get();
+        event._sigev_un._tid = tid_.load();
+#endif
+        if (timer_create(CLOCK_MONOTONIC, &event, &timer->id_) == -1) {
+            *err = errno;
+            return nullptr;
+        }
+        timer->created_ = true;
+        timers_.push_back(std::move(timer));
+        return timers_.back().get();
+    }
+
+    class Timer {
+    public:
+        ~Timer() {
+            if (created_) timer_delete(id_);
+        }
+
+        // Fires once at the absolute CLOCK_MONOTONIC time (ns) unless disarmed first.
+        // sequence identifies this arming (non-zero, different from the previous one).
+        int arm(std::int64_t deadlineNs, std::uint64_t sequence) {
+            deadline_.store(deadlineNs, std::memory_order_relaxed);
+            armed_.store(sequence, std::memory_order_release);
+            itimerspec spec;
+            memset(&spec, 0, sizeof(spec));
+            spec.it_value.tv_sec = static_cast<time_t>(deadlineNs / 1000000000);
+            spec.it_value.tv_nsec = static_cast<long>(deadlineNs % 1000000000);
+            return timer_settime(id_, TIMER_ABSTIME, &spec, nullptr) == -1 ? errno : 0;
+        }
+
+        int disarm() {
+            armed_.store(0, std::memory_order_release);  // Expiries still queued are ignored from here on
+            itimerspec spec;
+            memset(&spec, 0, sizeof(spec));
+            return timer_settime(id_, 0, &spec, nullptr) == -1 ? errno : 0;
+        }
+
+    private:
+        friend class OverrunWatchdog;
+        explicit Timer(std::function<void(std::uint64_t)> onExpire) : onExpire_(std::move(onExpire)) {}
+
+        // Watchdog thread: drops notifications of an earlier arming (or one already reported)
+        void expired() {
+            std::uint64_t sequence = armed_.load(std::memory_order_acquire);
+            if (sequence == 0 || sequence == reported_) return;
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            std::int64_t nowNs = static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+            if (nowNs < deadline_.load(std::memory_order_relaxed)) {
+                return;  // Queued by the previous arming; the current one has not expired
+            }
+            reported_ = sequence;
+            onExpire_(sequence);
+        }
+
+        std::function<void(std::uint64_t)> onExpire_;
+        timer_t id_{};
+        bool created_ = false;
+        std::atomic<std::uint64_t> armed_{0};  // Sequence of the current arming, 0 while disarmed
+        std::atomic<std::int64_t> deadline_{0};
+        std::uint64_t reported_ = 0;           // Watchdog thread only
+    };
+
+private:
+    // Starts the watchdog thread on first use and waits until it can receive notifications
+    int start() {
+        if (thread_.joinable()) return 0;
+#ifdef __QNX__
+        chid_ = ChannelCreate(_NTO_CHF_PRIVATE);
+        if (chid_ == -1) return errno;
+        coid_ = ConnectAttach(0, 0, chid_, _NTO_SIDE_CHANNEL, _NTO_COF_CLOEXEC);
+        if (coid_ == -1) return errno;
+#endif
+        thread_ = std::thread([this] { receiveLoop(); });
+        tid_.wait(0);
+        if (tid_.load() == -1) {
+            thread_.join();
+            return startError_;
+        }
+        return 0;
+    }
+
+    // Runs on the watchdog thread; reports through tid_ (-1 and startError_ on failure)
+    bool prepareThread() {
+        if (priority_ > 0) {
+            sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = priority_;
+            startError_ = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        }
+#ifndef __QNX__
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, kSignal);
+        if (startError_ == 0) startError_ = pthread_sigmask(SIG_BLOCK, &set, nullptr);
+#endif
+        tid_.store(startError_ == 0 ? currentTid() : -1);
+        tid_.notify_all();
+        return startError_ == 0;
+    }
+
+#ifdef __QNX__
+    static constexpr int kExpiredCode = _PULSE_CODE_MINAVAIL;
+    static constexpr int kStopCode = _PULSE_CODE_MINAVAIL + 1;
+
+    static int currentTid() { return static_cast<int>(pthread_self()); }  // QNX thread ids are small ints
+
+    void receiveLoop() {
+        if (!prepareThread()) return;
+        for (;;) {
+            struct _pulse pulse;
+            if (MsgReceivePulse(chid_, &pulse, sizeof(pulse), nullptr) == -1) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            if (pulse.code == kStopCode) return;
+            if (pulse.code == kExpiredCode) {
+                static_cast<Timer*>(pulse.value.sival_ptr)->expired();
+            }
+        }
+    }
+
+    int chid_ = -1;
+    int coid_ = -1;
+#else
+    static inline const int kSignal = SIGRTMIN + 2;  // Only ever delivered to the watchdog thread
+
+    static int currentTid() { return static_cast<int>(syscall(SYS_gettid)); }
+
+    void receiveLoop() {
+        if (!prepareThread()) return;
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, kSignal);
+        for (;;) {
+            siginfo_t info;
+            if (sigwaitinfo(&set, &info) == -1) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            if (info.si_value.sival_ptr == nullptr) return;  // Stop request from the destructor
+            static_cast<Timer*>(info.si_value.sival_ptr)->expired();
+        }
+    }
+#endif
+
+    int priority_;
+    int startError_ = 0;
+    std::atomic<int> tid_{0};
+    std::thread thread_;
+    std::vector<std::unique_ptr<Timer>> timers_;
+};
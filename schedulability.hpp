@@ -0,0 +1,193 @@
+/*Schedulability Analysis - Rate-Monotonic Response Times and EDF Utilization from Measured WCETs
+A per-task deadline check says whether one task made it this time. Whether a whole task set can
+ever miss, and how much more work fits on a core, depends on all tasks sharing that core together.
+
+analyzeFixedPriority() uses the priorities the tasks actually run at (TaskConfig::priority, higher
+first; equal priorities in rate-monotonic order), analyzeRateMonotonic() assumes rate-monotonic
+priorities (shorter period = higher priority) whatever was configured. Both run exact response-time analysis:
+    R = C_i + sum over higher-priority j of ceil(R / T_j) * C_j, iterated until R stops changing.
+A task is schedulable if R <= D_i; its slack is D_i - R. The extra budget is the largest increase of
+C_i for which every task on the core still meets its deadline (found by bisection).
+analyzeEdf() runs the EDF test: total utilization sum(C/T) <= 1 is exact when every D >= T;
+for constrained deadlines (D < T) the density test sum(C / min(D, T)) <= 1 is used, which is sufficient.
+Under EDF a task's extra budget is the spare capacity times its own period (or deadline).
+
+WCETs come from PeriodicExecutor measurements (fromExecutor) multiplied by a safety margin, because
+a measured maximum is an observation, not a bound. Analyze one core at a time.*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rt_executor.hpp"
+
+struct TaskTiming {
+    std::string name;
+    std::int64_t periodNs;
+    std::int64_t deadlineNs;  // Relative
+    std::int64_t wcetNs;
+    int priority = 0;         // Fixed priority it runs at, higher preempts lower (analyzeFixedPriority only)
+};
+
+struct TaskVerdict {
+    std::string name;
+    bool schedulable;
+    std::int64_t responseNs;     // RM: worst-case response time (> deadline if unschedulable); EDF: unused (0)
+    std::int64_t slackNs;        // RM: deadline - response; EDF: spare capacity over one deadline
+    std::int64_t extraBudgetNs;  // Additional execution time this task could take; 0 if none
+};
+
+struct SchedulabilityReport {
+    const char* test;
+    bool fixedPriority;  // Per-task response times are only meaningful for fixed priorities
+    double utilization;  // sum(C/T); for the EDF density test sum(C / min(D, T))
+    double bound;        // Fixed priority: Liu & Layland n(2^(1/n) - 1), for reference (1 for n <= 1); EDF: 1
+    bool schedulable;
+    std::vector<TaskVerdict> tasks;
+};
+
+// Tasks of one core (cpu == -1: all tasks), WCET = measured maximum * margin
+inline std::vector<TaskTiming> fromExecutor(const PeriodicExecutor& executor, int cpu = -1, double margin = 1.2) {
+    std::vector<TaskTiming> timings;
+    for (const auto& task : executor.tasks()) {
+        if (cpu != -1 && task->config.cpu != cpu) continue;
+        int priority = task->config.policy == SCHED_OTHER ? 0 : task->config.priority;
+        timings.push_back(TaskTiming{task->name, task->period.count(), task->deadline.count(),
+                                     static_cast<std::int64_t>(std::ceil(task->stats.execution.max() * margin)),
+                                     priority});
+    }
+    return timings;
+}
+
+inline double utilization(const std::vector<TaskTiming>& tasks) {
+    double u = 0;
+    for (const auto& t : tasks) u += static_cast<double>(t.wcetNs) / t.periodNs;
+    return u;
+}
+
+namespace sched_detail {
+
+// Sorted highest priority first; ties broken by the shorter deadline
+inline std::vector<TaskTiming> rateMonotonicOrder(std::vector<TaskTiming> tasks) {
+    std::stable_sort(tasks.begin(), tasks.end(), [](const TaskTiming& a, const TaskTiming& b) {
+        return a.periodNs != b.periodNs ? a.periodNs < b.periodNs : a.deadlineNs < b.deadlineNs;
+    });
+    return tasks;
+}
+
+// Configured priorities, highest first; equal priorities fall back to rate-monotonic order
+inline std::vector<TaskTiming> priorityOrder(std::vector<TaskTiming> tasks) {
+    tasks = rateMonotonicOrder(std::move(tasks));
+    std::stable_sort(tasks.begin(), tasks.end(),
+                     [](const TaskTiming& a, const TaskTiming& b) { return a.priority > b.priority; });
+    return tasks;
+}
+
+// Liu & Layland bound; an empty set or a single task can use the whole core
+inline double liuLaylandBound(std::size_t count) {
+    if (count <= 1) return 1.0;
+    double n = static_cast<double>(count);
+    return n * (std::pow(2.0, 1.0 / n) - 1);
+}
+
+// Response time of ordered[i], or the first iterate beyond its deadline if it cannot make it
+inline std::int64_t responseTime(const std::vector<TaskTiming>& ordered, std::size_t i) {
+    std::int64_t response = ordered[i].wcetNs;
+    for (;;) {
+        std::int64_t next = ordered[i].wcetNs;
+        for (std::size_t j = 0; j < i; ++j) {
+            next += (response + ordered[j].periodNs - 1) / ordered[j].periodNs * ordered[j].wcetNs;
+        }
+        if (next == response || next > ordered[i].deadlineNs) return next;
+        response = next;
+    }
+}
+
+inline bool allMeetDeadlines(const std::vector<TaskTiming>& ordered) {
+    for (std::size_t i = 0; i < ordered.size(); ++i) {
+        if (responseTime(ordered, i) > ordered[i].deadlineNs) return false;
+    }
+    return true;
+}
+
+// Response-time analysis of tasks sorted highest priority first
+inline SchedulabilityReport analyzeOrdered(const char* test, const std::vector<TaskTiming>& ordered) {
+    SchedulabilityReport report{test, true, utilization(ordered), liuLaylandBound(ordered.size()), true, {}};
+    bool all = sched_detail::allMeetDeadlines(ordered);
+    for (std::size_t i = 0; i < ordered.size(); ++i) {
+        std::int64_t response = sched_detail::responseTime(ordered, i);
+        TaskVerdict verdict{ordered[i].name, response <= ordered[i].deadlineNs, response,
+                            ordered[i].deadlineNs - response, 0};
+        report.schedulable = report.schedulable && verdict.schedulable;
+
+        // Bisection on the extra execution time: the largest delta that keeps the whole set schedulable
+        if (all) {
+            std::vector<TaskTiming> trial = ordered;
+            std::int64_t lo = 0, hi = ordered[i].deadlineNs;
+            while (lo < hi) {
+                std::int64_t mid = lo + (hi - lo + 1) / 2;
+                trial[i].wcetNs = ordered[i].wcetNs + mid;
+                if (sched_detail::allMeetDeadlines(trial)) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            verdict.extraBudgetNs = lo;
+        }
+        report.tasks.push_back(verdict);
+    }
+    return report;
+}
+
+}  // namespace sched_detail
+
+// Rate-monotonic priorities assumed, regardless of TaskTiming::priority
+inline SchedulabilityReport analyzeRateMonotonic(const std::vector<TaskTiming>& tasks) {
+    return sched_detail::analyzeOrdered("rate-monotonic", sched_detail::rateMonotonicOrder(tasks));
+}
+
+// The configured priorities (fromExecutor() copies them from each task's TaskConfig)
+inline SchedulabilityReport analyzeFixedPriority(const std::vector<TaskTiming>& tasks) {
+    return sched_detail::analyzeOrdered("fixed priority", sched_detail::priorityOrder(tasks));
+}
+
+inline SchedulabilityReport analyzeEdf(const std::vector<TaskTiming>& tasks) {
+    bool constrained = false;
+    double density = 0;
+    for (const auto& t : tasks) {
+        std::int64_t window = std::min(t.deadlineNs, t.periodNs);
+        constrained = constrained || t.deadlineNs < t.periodNs;
+        density += static_cast<double>(t.wcetNs) / window;
+    }
+    SchedulabilityReport report{constrained ? "EDF (density)" : "EDF (utilization)", false, density, 1.0,
+                                density <= 1.0, {}};
+    double spare = std::max(0.0, 1.0 - density);
+    for (const auto& t : tasks) {
+        std::int64_t window = std::min(t.deadlineNs, t.periodNs);
+        std::int64_t slack = static_cast<std::int64_t>(spare * window);
+        report.tasks.push_back(TaskVerdict{t.name, report.schedulable, 0, slack, slack});
+    }
+    return report;
+}
+
+inline void printSchedulability(const SchedulabilityReport& report, std::FILE* out = stdout) {
+    std::fprintf(out, "%s: U = %.3f (bound %.3f) -> %s\n", report.test, report.utilization, report.bound,
+                 report.schedulable ? "schedulable" : "NOT schedulable");
+    for (const auto& t : report.tasks) {
+        if (report.fixedPriority) {
+            std::fprintf(out, "  %-12s R = %9.1fus  slack %9.1fus  extra budget %9.1fus%s\n", t.name.c_str(),
+                         t.responseNs / 1e3, t.slackNs / 1e3, t.extraBudgetNs / 1e3,
+                         t.schedulable ? "" : "  MISSES");
+        } else {
+            std::fprintf(out, "  %-12s slack %9.1fus  extra budget %9.1fus\n", t.name.c_str(), t.slackNs / 1e3,
+                         t.extraBudgetNs / 1e3);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*SensorChannel<T> - Lock-Free Single-Writer / Multi-Reader Publication
+std::atomic<int> only works while a sample fits in one machine word. Real sensors produce
+multi-field samples (value, timestamp, sequence number), and publishing those through a plain
+pointer or a struct copy lets a reader see half of an old sample and half of a new one (tearing).
+
+SensorChannel<T> is a seqlock:
+The writer bumps a sequence counter to an odd value, copies the sample in, then bumps it back to even.
+A reader copies the sample out and retries if the counter was odd or changed while it was copying.
+
+The writer never blocks and never waits for readers, so adding readers does not slow the producer.
+Readers never write shared state, so they do not contend with each other either.
+T must be trivially copyable (plain struct of numbers) because it is copied word by word.
+
+Readers can either poll with read(), or block in waitForUpdate() until something new is published.
+waitForUpdate() sleeps on the sequence counter itself (C++20 std::atomic::wait, a futex on Linux),
+so a reader wakes exactly once per new sample instead of on a fixed timer.*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+template <typename T>
+class SensorChannel {
+    static_assert(std::is_trivially_copyable<T>::value, "SensorChannel<T> requires a trivially copyable T");
+
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+public:
+    SensorChannel() : SensorChannel(T{}) {}
+
+    explicit SensorChannel(const T& initial) {
+        storeWords(initial);
+    }
+
+    SensorChannel(const SensorChannel&) = delete;
+    SensorChannel& operator=(const SensorChannel&) = delete;
+
+    // Writer side: must only be called from one thread. Never blocks.
+    void publish(const T& sample) {
+        std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);   // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        storeWords(sample);
+        seq_.store(seq + 2, std::memory_order_release);   // Even: sample complete
+        seq_.notify_all();                                // Wake readers blocked in waitForUpdate()
+    }
+
+    // Reader side: any number of threads. Returns a consistent snapshot.
+    T read() const {
+        T sample;
+        while (!tryRead(sample)) {
+            std::this_thread::yield();  // Writer was mid-update; try again
+        }
+        return sample;
+    }
+
+    // Blocks until a sample newer than seenVersion is published, returns it and advances seenVersion.
+    // To release blocked readers at shutdown, publish() one final sample.
+    T waitForUpdate(std::uint64_t& seenVersion) const {
+        T sample;
+        for (;;) {
+            std::uint64_t seq = seq_.load(std::memory_order_acquire);
+            if (seq / 2 <= seenVersion) {
+                seq_.wait(seq, std::memory_order_acquire);  // Sleeps until the counter changes
+                continue;
+            }
+            if (tryRead(sample, &seenVersion)) {
+                return sample;
+            }
+        }
+    }
+
+    // Single attempt; returns false if the writer was mid-update.
+    bool tryRead(T& out, std::uint64_t* version = nullptr) const {
+        std::uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::uint64_t words[kWords];
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        if (version) {
+            *version = before / 2;
+        }
+        return true;
+    }
+
+    // Number of completed publications (each publish() advances it by one).
+    std::uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    void storeWords(const T& sample) {
+        std::uint64_t words[kWords] = {};
+        std::memcpy(words, &sample, sizeof(T));
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> words_[kWords];
+};
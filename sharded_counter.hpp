@@ -0,0 +1,59 @@
+/*ShardedCounter - Contention-Free Event Counting Across Threads
+A plain int incremented from several threads is a data race; a single std::atomic<int> fixes that,
+but every increment then bounces the same cache line between all the cores that count.
+
+ShardedCounter spreads the count over Shards cache-line-padded atomics.
+Each thread is assigned its own shard the first time it counts, so an increment is an
+uncontended relaxed fetch_add on a line that stays in that core's cache.
+value() sums the shards; it is the only operation that touches every line, so call it when you
+need the number (stats, reporting), not on the hot path.*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "cache_line.hpp"
+
+namespace sharded_counter_detail {
+
+// Round-robin shard assignment, fixed for the lifetime of each thread
+inline std::size_t threadShardIndex() {
+    static std::atomic<std::size_t> nextIndex{0};
+    thread_local std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+}  // namespace sharded_counter_detail
+
+template <std::size_t Shards = 64>
+class ShardedCounter {
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+public:
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(std::uint64_t n = 1) {
+        shards_[sharded_counter_detail::threadShardIndex() & (Shards - 1)]->fetch_add(n, std::memory_order_relaxed);
+    }
+
+    ShardedCounter& operator++() {
+        add(1);
+        return *this;
+    }
+
+    // Aggregate over all shards. Not a snapshot: increments racing with the sum may or may not be included.
+    std::uint64_t value() const {
+        std::uint64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard->load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    CachePadded<std::atomic<std::uint64_t>> shards_[Shards] = {};
+};
@@ -7,18 +7,94 @@ Copy
 Edit*/
 
 #include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <thread>
 
-volatile int sensorData = 10;  // Can change anytime (e.g., by hardware)
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "register_block.hpp"
+#include "register_wait.hpp"
+
+volatile int* sensorData;  // A device register: can change anytime, outside this program's control
 
 void readSensor() {
-    while (sensorData != 20) {  // This loop won’t be optimized away
-        std::cout << "Waiting for sensor update...\n";
+    // Re-reads *sensorData (it's volatile) but backs off instead of spinning and printing on every read
+    WaitResult result = wait_until(*sensorData, [](int value) { return value == 20; });
+    std::cout << "Sensor updated to 20! (waited "
+              << std::chrono::duration_cast<std::chrono::microseconds>(result.waited).count() << " us, "
+              << result.polls << " reads)\n";
+}
+
+// A real driver maps whole register blocks. Layout of a (made-up) sensor ADC, straight from its datasheet:
+struct SensorAdcLayout {
+    static constexpr std::size_t kSize = 0x20;
+    using Status = RegField<std::uint32_t, 0x00, 0, 1, RegAccess::ReadOnly>;      // Conversion done
+    using Overrun = RegField<std::uint32_t, 0x00, 1, 1, RegAccess::ReadOnly>;     // Sample lost
+    using Channel = RegField<std::uint32_t, 0x00, 8, 4, RegAccess::ReadOnly>;     // Channel converted
+    using Sample = RegField<std::uint32_t, 0x04, 0, 16, RegAccess::ReadOnly>;
+    using Timestamp = RegField<std::uint32_t, 0x08, 0, 32, RegAccess::ReadOnly>;
+    using Enable = RegField<std::uint32_t, 0x10, 0, 1>;                           // Control register
+    using Gain = RegField<std::uint32_t, 0x10, 4, 3>;
+    using ClearIrq = RegField<std::uint32_t, 0x14, 0, 32, RegAccess::WriteOnly>;
+};
+
+void readAdcBlock() {
+    // On target: RegisterBlock<SensorAdcLayout> adc(0xfe200000); here a plain buffer stands in for the device
+    alignas(8) static std::uint32_t device[SensorAdcLayout::kSize / 4] = {0x0501, 1234, 987654};
+    auto adc = RegisterBlock<SensorAdcLayout>::attach(device);
+
+    adc.write<SensorAdcLayout::Enable, SensorAdcLayout::Gain>(1, 3);  // One read-modify-write for both fields
+    auto status = adc.snapshot<std::uint32_t, 0x00, 3>();               // Status, Sample, Timestamp: 3 reads total
+    if (status.get<SensorAdcLayout::Status>()) {
+        std::cout << "ADC channel " << status.get<SensorAdcLayout::Channel>() << " sample "
+                  << status.get<SensorAdcLayout::Sample>() << " at " << status.get<SensorAdcLayout::Timestamp>()
+                  << (status.get<SensorAdcLayout::Overrun>() ? " (overrun)" : "") << "\n";
     }
-    std::cout << "Sensor updated to 20!\n";
+    adc.write<SensorAdcLayout::ClearIrq>(1);  // Whole-register field: a plain store, no read first
+    // adc.write<SensorAdcLayout::Sample>(0);  // Would not compile: Sample is read-only
 }
 
 int main() {
+    // Stands in for the hardware: a page shared with a child process, which changes the value 50 ms from now.
+    // Like a device, the child is outside this program; a second thread writing a volatile int would
+    // instead be a data race (volatile is not for communication between threads).
+    void* page = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+    sensorData = static_cast<volatile int*>(page);
+    *sensorData = 10;
+    pid_t device = fork();
+    if (device == -1) {
+        std::perror("fork");
+        return 1;
+    }
+    if (device == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        *sensorData = 20;
+        _exit(0);
+    }
     readSensor();
+    waitpid(device, nullptr, 0);
+    munmap(page, 4096);
+    readAdcBlock();
 }
 /*🔹 Why volatile?
-Without volatile, the compiler might assume sensorData never changes inside the loop and optimize away the repeated checks, causing an infinite loop.*/
+Without volatile, the compiler might assume sensorData never changes inside the loop and optimize away the repeated checks, causing an infinite loop.
+volatile is for memory changed by something outside the program (a device, another process through shared
+memory). Between threads of one program use std::atomic: a volatile variable shared by threads is a data race.
+
+🔹 Why wait_until() instead of while (sensorData != 20)?
+The plain loop keeps a core at 100% for the whole wait. wait_until() spins only for the first few
+microseconds, then sleeps with growing intervals, and can block on the device's interrupt on QNX
+(WaitPolicy::block = InterruptEvent::wait), so a 50 ms wait costs about two thousand reads (most of them in the first microseconds) instead of millions.
+
+🔹 Why RegisterBlock instead of volatile globals?
+Each volatile access is a real bus transaction, and uncached device reads are slow. Reading five
+status fields one at a time costs five reads of the same register; snapshot() reads each register of
+the block once and decodes all fields from the copy. Offsets, widths and access rights come from one
+Layout, and using a field the wrong way fails to compile.*/